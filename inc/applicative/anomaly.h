@@ -0,0 +1,48 @@
+/*
+ * anomaly.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef ANOMALY_H
+#define ANOMALY_H
+
+/*** ANOMALY macros ***/
+
+#define ANOMALY_SIGMA_THRESHOLD_DEFAULT		4
+#define ANOMALY_SIGMA_THRESHOLD_MAX			15
+#define ANOMALY_NUMBER_OF_BUCKETS			8
+
+// Status word fields.
+#define ANOMALY_STATUS_BIT_LAST				0 // Last sample was anomalous.
+#define ANOMALY_STATUS_BIT_LAST_HIGH		1 // Last anomaly was above baseline.
+#define ANOMALY_STATUS_BIT_LEARNED			2 // Baseline of current bucket is learned.
+#define ANOMALY_STATUS_BIT_LEAKAGE			3 // Output voltage or current detected while relay is open.
+#define ANOMALY_STATUS_SHIFT_BUCKET			4 // Current time-of-day bucket (4 bits).
+#define ANOMALY_STATUS_SHIFT_CONSECUTIVE	8 // Number of consecutive anomalies (saturated to 127).
+#define ANOMALY_STATUS_SHIFT_HIGH_COUNT		16 // Number of anomalies above baseline (saturated to 127).
+#define ANOMALY_STATUS_SHIFT_LOW_COUNT		24 // Number of anomalies below baseline (saturated to 127).
+
+/*** ANOMALY structures ***/
+
+typedef struct {
+	int mean_ua;
+	unsigned long long variance_ua2;
+	unsigned char sample_count;
+} ANOMALY_baseline_t;
+
+/*** ANOMALY functions ***/
+
+void ANOMALY_init(void);
+void ANOMALY_set_sigma_threshold(unsigned char sigma_threshold);
+unsigned char ANOMALY_get_sigma_threshold(void);
+unsigned char ANOMALY_process(unsigned int iout_ua, unsigned int timestamp_seconds);
+void ANOMALY_process_idle(unsigned int iout_ua, unsigned int vout_mv);
+unsigned int ANOMALY_get_iout_offset(void);
+void ANOMALY_set_iout_offset(unsigned int iout_offset_ua);
+unsigned int ANOMALY_get_status(void);
+void ANOMALY_clear_counters(void);
+void ANOMALY_get_baselines(ANOMALY_baseline_t* baseline);
+
+#endif /* ANOMALY_H */
@@ -8,10 +8,34 @@
 #ifndef AT_H
 #define AT_H
 
+#include "mode.h"
+
+/*** AT structures ***/
+
+#ifdef ALARM_PUSH
+typedef enum {
+	AT_ALARM_OVERCURRENT = 0,
+	AT_ALARM_UNDERCURRENT,
+	AT_ALARM_UNDERVOLTAGE,
+	AT_ALARM_LEAKAGE,
+	AT_ALARM_LAST
+} AT_alarm_t;
+#endif
+
 /*** AT functions ***/
 
 void AT_init(void);
 void AT_task(void);
+unsigned char AT_is_command_pending(void);
 void AT_fill_rx_buffer(unsigned char rx_byte);
+#ifdef BULK_TRANSFER
+void AT_start_transfer(unsigned char* data, unsigned int length);
+#endif
+void AT_update_status_frame(void);
+#ifdef ALARM_PUSH
+void AT_latch_alarm(AT_alarm_t alarm);
+void AT_set_alarm_push(unsigned char enable);
+unsigned char AT_get_alarm_push(void);
+#endif
 
 #endif /* AT_H */
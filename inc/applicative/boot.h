@@ -0,0 +1,57 @@
+/*
+ * boot.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "mode.h"
+#include "rtc.h"
+
+/*** BOOT structures ***/
+
+typedef enum {
+	BOOT_PHASE_CLOCKS = 0, // Power interface and LSI start.
+	BOOT_PHASE_GPIO, // Watchdog, GPIOs and EXTI.
+	BOOT_PHASE_LSE, // LSE start (skipped on storage wake-up).
+	BOOT_PHASE_RTC, // RTC init with LSI fallback.
+	BOOT_PHASE_MSI_CALIBRATION, // Skipped on storage wake-up.
+	BOOT_PHASE_PERIPHERALS, // LPTIM, LPUART and NVM.
+	BOOT_PHASE_ADC, // ADC init and calibration.
+	BOOT_PHASE_APPLICATION, // Components and applicative layers.
+	BOOT_PHASE_LAST
+} BOOT_phase_t;
+
+typedef struct {
+	unsigned int phase_duration_us[BOOT_PHASE_LAST];
+	RTC_clock_source_t rtc_clock_source;
+	unsigned char storage_resume;
+} BOOT_profile_t;
+
+/*** BOOT macros ***/
+
+// Profiling hooks (removed when boot profile is disabled).
+#ifdef BOOT_PROFILE
+#define BOOT_INIT()							BOOT_init()
+#define BOOT_END_PHASE(phase)				BOOT_end_phase(phase)
+#define BOOT_SET_RTC_CLOCK_SOURCE(source)	BOOT_set_rtc_clock_source(source)
+#define BOOT_SET_STORAGE_RESUME(resume)		BOOT_set_storage_resume(resume)
+#else
+#define BOOT_INIT()
+#define BOOT_END_PHASE(phase)
+#define BOOT_SET_RTC_CLOCK_SOURCE(source)
+#define BOOT_SET_STORAGE_RESUME(resume)
+#endif
+
+/*** BOOT functions ***/
+
+void BOOT_init(void);
+void BOOT_end_phase(BOOT_phase_t phase);
+void BOOT_set_rtc_clock_source(RTC_clock_source_t rtc_clock_source);
+void BOOT_set_storage_resume(unsigned char storage_resume);
+void BOOT_get_profile(BOOT_profile_t* profile);
+
+#endif /* BOOT_H */
@@ -0,0 +1,36 @@
+/*
+ * governor.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+/*** GOVERNOR structures ***/
+
+typedef enum {
+	GOVERNOR_RESIDENCY_RUN = 0,
+	GOVERNOR_RESIDENCY_SLEEP, // Sleep mode is only used while the LED is blinking.
+	GOVERNOR_RESIDENCY_LAST
+} GOVERNOR_residency_t;
+
+typedef struct {
+	unsigned int measurement_period_seconds;
+	unsigned int led_period_seconds;
+} GOVERNOR_settings_t;
+
+/*** GOVERNOR functions ***/
+
+void GOVERNOR_init(unsigned int uptime_seconds);
+void GOVERNOR_set_target(unsigned int target_ua);
+unsigned int GOVERNOR_get_target(void);
+void GOVERNOR_add_residency(GOVERNOR_residency_t residency, unsigned int duration_us);
+unsigned int GOVERNOR_get_residency_ms(GOVERNOR_residency_t residency);
+void GOVERNOR_task(unsigned int uptime_seconds);
+void GOVERNOR_get_settings(GOVERNOR_settings_t* settings);
+unsigned char GOVERNOR_get_level(void);
+unsigned int GOVERNOR_get_average_current(void);
+
+#endif /* GOVERNOR_H */
@@ -0,0 +1,21 @@
+/*
+ * storage.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef STORAGE_H
+#define STORAGE_H
+
+/*** STORAGE functions ***/
+
+unsigned char STORAGE_init(void);
+void STORAGE_set_enable(unsigned char enable);
+unsigned char STORAGE_get_enable(void);
+unsigned int STORAGE_get_standby_count(void);
+void STORAGE_clear_standby_count(void);
+void STORAGE_restore_context(void);
+void STORAGE_enter(unsigned int wakeup_period_seconds);
+
+#endif /* STORAGE_H */
@@ -8,11 +8,25 @@
 #ifndef LED_H
 #define LED_H
 
+#include "rtc.h"
 #include "tim.h"
 
+/*** LED macros ***/
+
+#define LED_LOAD_PERIOD_DEFAULT_SECONDS		RTC_WAKEUP_PERIOD_SECONDS
+#define LED_LOAD_PERIOD_MAX_SECONDS			RTC_ALARM_DELAY_MAX_SECONDS
+
 /*** LED functions ***/
 
 void LED_init(void);
 void LED_single_blink(unsigned int blink_duration_ms, TIM2_channel_mask_t color);
+void LED_start_single_blink(unsigned int blink_duration_ms, TIM2_channel_mask_t color);
+void LED_stop(void);
+unsigned char LED_is_active(void);
+void LED_notify_activity(void);
+void LED_set_load_color(TIM2_channel_mask_t color);
+void LED_set_load_period(unsigned int load_period_seconds);
+unsigned int LED_get_load_period(void);
+void LED_task(void);
 
 #endif /* LED_H */
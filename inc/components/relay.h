@@ -12,5 +12,6 @@
 
 void RELAY_init(void);
 void RELAY_set_state(unsigned char enable);
+unsigned char RELAY_get_state(void);
 
 #endif /* RELAY_H */
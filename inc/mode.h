@@ -16,6 +16,29 @@
 
 //#define DEBUG		// Use programming pins for debug purpose if defined.
 
+/*** Instrumentation ***/
+
+//#define IRQ_STATS	// Measure interrupts latency, duration and masked time if defined.
+
+/*** Interrupts ***/
+
+//#define RAM_VECTORS	// Relocate vector table to RAM and install receive handlers at runtime if defined.
+
+/*** Optional features ***/
+
+// All disabled by default so that the image fits in the 8kB flash of the STM32L011F3.
+//#define MSI_CALIBRATION	// MSI trimming against LSE at boot and periodically if defined.
+//#define NVM_QUEUE			// Interrupt-driven data EEPROM programming with write queue if defined.
+//#define RETAINED_DATA		// Reset counters and output energy kept in .noinit RAM (AT$NOI) if defined.
+//#define ADC_STREAM		// Timer-triggered ADC bursts with CIC decimation and ripple analysis (AT$CIC, AT$RPF, AT$RPL) if defined.
+//#define ANOMALY_DETECTION	// Learned load baselines, sensor offset and leakage detection (AT$ANO, AT$ANC) if defined.
+//#define ALARM_PUSH		// Latched alarms pushed with bus arbitration (AT$ALM) if defined.
+//#define ENERGY_GOVERNOR	// Closed-loop average current budget (AT$GOV) if defined.
+//#define BULK_TRANSFER		// Bulk reads and preemptible chunked transfers (AT$BLS, AT$BLK, AT$BLT, AT$XFR) if defined.
+//#define STORAGE_MODE		// Standby mode when idle with output disabled (AT$STO) if defined.
+//#define DIAGNOSTICS		// Single TLV diagnostics record (AT$DIA) if defined.
+//#define BOOT_PROFILE		// Duration of each init phase (AT$BOT) if defined.
+
 /*** Error management ***/
 
 #if (defined RSM && defined ATM)
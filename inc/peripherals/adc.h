@@ -8,6 +8,8 @@
 #ifndef ADC_H
 #define ADC_H
 
+#include "mode.h"
+
 /*** ADC structures ***/
 
 typedef enum {
@@ -15,15 +17,39 @@ typedef enum {
 	ADC_DATA_IDX_VOUT_MV,
 	ADC_DATA_IDX_IOUT_UA,
 	ADC_DATA_IDX_VMCU_MV,
+	// Derived data (no acquisition).
+	ADC_DATA_IDX_POUT_MW,
 	ADC_DATA_IDX_MAX
 } ADC_data_index_t;
 
+typedef struct {
+	unsigned int data[ADC_DATA_IDX_MAX];
+	unsigned int timestamp_seconds;
+} ADC_snapshot_t;
+
+/*** ADC macros ***/
+
+#define ADC_DATA_IDX_ACQUIRED_MAX				ADC_DATA_IDX_POUT_MW // Number of data with an acquisition period.
+#define ADC_DATA_MASK_ALL						((0b1 << ADC_DATA_IDX_ACQUIRED_MAX) - 1)
+#ifdef ADC_STREAM
+#define ADC_STREAM_SAMPLING_FREQUENCY_HZ		4000 // Conversion time is 173 ADCCLK cycles (82us).
+#define ADC_STREAM_LENGTH_MAX_SAMPLES			8192 // 2 seconds at 4kHz, well below the IWDG period.
+#define ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX	4
+#endif
+
 /*** ADC functions ***/
 
 void ADC1_init(void);
 void ADC1_enable(void);
 void ADC1_disable(void);
-void ADC1_perform_measurements(void);
+void ADC1_perform_measurements(unsigned char data_mask);
+#ifdef ADC_STREAM
+unsigned char ADC1_perform_decimated_measurement(ADC_data_index_t data_idx, unsigned char cic_order, unsigned char cic_ratio_log2, unsigned int* data);
+unsigned char ADC1_perform_ripple_analysis(ADC_data_index_t data_idx, unsigned int* frequencies_hz, unsigned char number_of_frequencies, unsigned int* amplitudes);
+#endif
 void ADC1_get_data(ADC_data_index_t data_idx, unsigned int* data);
+unsigned int ADC1_get_timestamp_seconds(void);
+unsigned int ADC1_get_sequence(void);
+void ADC1_get_snapshot(ADC_snapshot_t* snapshot);
 
 #endif /* ADC_H */
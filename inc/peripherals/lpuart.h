@@ -8,11 +8,30 @@
 #ifndef LPUART_H
 #define LPUART_H
 
+#include "mode.h"
+
+/*** LPUART structures ***/
+
+#ifdef RAM_VECTORS
+typedef enum {
+	LPUART_RX_MODE_AT = 0,
+	LPUART_RX_MODE_LAST
+} LPUART_rx_mode_t;
+#endif
+
 /*** LPUART functions ***/
 
 void LPUART1_init(void);
 void LPUART1_enable_rx(void);
 void LPUART1_disable_rx(void);
 void LPUART1_send_string(char* tx_string);
+void LPUART1_send_bytes(unsigned char* tx_data, unsigned int tx_length);
+#ifdef ALARM_PUSH
+unsigned char LPUART1_send_bytes_arbitrated(unsigned char* tx_data, unsigned int tx_length);
+#endif
+unsigned char LPUART1_get_node_address(void);
+#ifdef RAM_VECTORS
+void LPUART1_set_rx_mode(LPUART_rx_mode_t rx_mode);
+#endif
 
 #endif /* LPUART_H */
@@ -8,6 +8,8 @@
 #ifndef NVIC_H
 #define NVIC_H
 
+#include "mode.h"
+
 /*** NVIC interrupts vector ***/
 
 typedef enum {
@@ -43,16 +45,60 @@ typedef enum {
 	NVIC_IT_LPUART1 = 29
 } NVIC_interrupt_t;
 
+typedef void (*NVIC_handler_t)(void);
+
 typedef enum {
 	NVIC_PRIORITY_MAX = 0,
 	NVIC_PRIORITY_MIN = 3
 } NVIC_priority_t;
 
+#ifdef IRQ_STATS
+// Instrumented interrupt sources.
+typedef enum {
+	NVIC_STATS_SOURCE_LPUART1 = 0,
+	NVIC_STATS_SOURCE_TIM21,
+	NVIC_STATS_SOURCE_RTC,
+	NVIC_STATS_SOURCE_LPTIM1,
+	NVIC_STATS_SOURCE_FLASH,
+	NVIC_STATS_SOURCE_LAST
+} NVIC_stats_source_t;
+
+typedef enum {
+	NVIC_STATS_LATENCY_MIN_US = 0,
+	NVIC_STATS_LATENCY_MAX_US,
+	NVIC_STATS_LATENCY_AVERAGE_US,
+	NVIC_STATS_DURATION_MIN_US,
+	NVIC_STATS_DURATION_MAX_US,
+	NVIC_STATS_DURATION_AVERAGE_US,
+	NVIC_STATS_MASKED_MAX_US,
+	NVIC_STATS_LAST
+} NVIC_stats_index_t;
+#endif
+
+/*** NVIC macros ***/
+
+// Handler instrumentation (must be the first and last statements of the handler).
+#ifdef IRQ_STATS
+#define NVIC_STATS_ENTER(it_num)	unsigned int nvic_stats_entry_count = NVIC_stats_enter()
+#define NVIC_STATS_EXIT(it_num)		NVIC_stats_exit(it_num, nvic_stats_entry_count)
+#else
+#define NVIC_STATS_ENTER(it_num)
+#define NVIC_STATS_EXIT(it_num)
+#endif
+
 /*** NVIC functions ***/
 
 void NVIC_init(void);
 void NVIC_enable_interrupt(NVIC_interrupt_t it_num);
 void NVIC_disable_interrupt(NVIC_interrupt_t it_num);
 void NVIC_set_priority(NVIC_interrupt_t it_num, unsigned char priority);
+#ifdef RAM_VECTORS
+void NVIC_set_handler(NVIC_interrupt_t it_num, NVIC_handler_t handler);
+#endif
+#ifdef IRQ_STATS
+unsigned int NVIC_stats_enter(void);
+void NVIC_stats_exit(NVIC_interrupt_t it_num, unsigned int entry_count);
+void NVIC_get_stats(NVIC_stats_source_t source, NVIC_stats_index_t stats_idx, unsigned int* value_us);
+#endif
 
 #endif /* NVIC_H */
@@ -0,0 +1,21 @@
+/*
+ * nvm.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef NVM_H
+#define NVM_H
+
+/*** NVM functions ***/
+
+void NVM_init(void);
+void NVM_read_byte(unsigned short address_offset, unsigned char* data);
+void NVM_write_byte(unsigned short address_offset, unsigned char data);
+void NVM_write_word(unsigned short address_offset, unsigned int data);
+unsigned char NVM_is_busy(void);
+void NVM_flush(void);
+unsigned int NVM_get_error_count(void);
+
+#endif /* NVM_H */
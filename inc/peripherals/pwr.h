@@ -14,5 +14,7 @@ void PWR_init(void);
 void PWR_enter_sleep_mode(void);
 void PWR_enter_low_power_sleep_mode(void);
 void PWR_enter_stop_mode(void);
+void PWR_enter_standby_mode(void);
+unsigned char PWR_get_standby_flag(void);
 
 #endif /* PWR_H */
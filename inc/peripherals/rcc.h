@@ -8,16 +8,38 @@
 #ifndef RCC_H
 #define RCC_H
 
+#include "mode.h"
+
 /*** RCC macros ***/
 
 #define RCC_LSI_FREQUENCY_HZ	38000
 #define RCC_LSE_FREQUENCY_HZ	32768
 #define RCC_MSI_FREQUENCY_KHZ	2100
 
+#ifdef MSI_CALIBRATION
+// MSI calibration against LSE.
+#define RCC_MSI_CALIBRATION_BOOT_STEPS		32
+#define RCC_MSI_CALIBRATION_PERIOD_WAKEUPS	12 // Periodic tracking step every 12 RTC wake-ups (1 minute).
+#endif
+
+// Reset flags.
+#define RCC_RESET_FLAG_LOW_POWER		(0b1 << 7)
+#define RCC_RESET_FLAG_WWDG				(0b1 << 6)
+#define RCC_RESET_FLAG_IWDG				(0b1 << 5)
+#define RCC_RESET_FLAG_SOFTWARE			(0b1 << 4)
+#define RCC_RESET_FLAG_POR				(0b1 << 3)
+#define RCC_RESET_FLAG_PIN				(0b1 << 2) // Also set by all internal resets.
+
 /*** RCC functions ***/
 
 void RCC_init(void);
 void RCC_enable_lsi(void);
 void RCC_enable_lse(void);
+#ifdef MSI_CALIBRATION
+void RCC_calibrate_msi(unsigned char max_steps);
+#endif
+void RCC_set_msi_trim(signed char msi_trim);
+signed char RCC_get_msi_trim(void);
+unsigned char RCC_get_reset_flags(void);
 
 #endif /* RCC_H */
@@ -15,14 +15,37 @@
 // RTC wake-up timer period.
 // Warning: this value must be lower than the watchdog period = 25s.
  #define RTC_WAKEUP_PERIOD_SECONDS	5
+// Backup registers (kept in standby mode, cleared by RTC reset).
+#define RTC_NUMBER_OF_BACKUP_REGISTERS	5
+// Alarm delay (only minutes and seconds are compared).
+#define RTC_ALARM_DELAY_MAX_SECONDS		3599
+
+/*** RTC structures ***/
+
+typedef enum {
+	RTC_CLOCK_SOURCE_NONE = 0,
+	RTC_CLOCK_SOURCE_LSE,
+	RTC_CLOCK_SOURCE_LSI,
+	RTC_CLOCK_SOURCE_HSE
+} RTC_clock_source_t;
 
 /*** RTC functions ***/
 
 void RTC_reset(void);
 void RTC_init(void);
+void RTC_resume(void);
+RTC_clock_source_t RTC_get_clock_source(void);
 void RTC_start_wakeup_timer(unsigned int delay_seconds);
 void RTC_stop_wakeup_timer(void);
+void RTC_restart_wakeup_timer(unsigned int delay_seconds);
 volatile unsigned char RTC_get_wakeup_timer_flag(void);
 void RTC_clear_wakeup_timer_flag(void);
+void RTC_start_alarm(unsigned int delay_seconds);
+void RTC_stop_alarm(void);
+volatile unsigned char RTC_get_alarm_flag(void);
+void RTC_clear_alarm_flag(void);
+unsigned int RTC_get_uptime_seconds(void);
+void RTC_write_backup_register(unsigned char register_idx, unsigned int value);
+unsigned int RTC_read_backup_register(unsigned char register_idx);
 
 #endif /* RTC_H */
@@ -0,0 +1,23 @@
+/*
+ * systick.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SYSTICK_H
+#define SYSTICK_H
+
+/*** SYSTICK macros ***/
+
+#define SYSTICK_COUNTER_MASK	0x00FFFFFF // 24-bits counter (8s at 2.1MHz).
+
+/*** SYSTICK functions ***/
+
+void SYSTICK_init(void);
+unsigned int SYSTICK_get_count(void);
+unsigned int SYSTICK_get_elapsed(unsigned int start_count);
+unsigned int SYSTICK_convert_to_us(unsigned int systick_count);
+unsigned int SYSTICK_get_time_us(void);
+
+#endif /* SYSTICK_H */
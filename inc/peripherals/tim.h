@@ -8,6 +8,14 @@
 #ifndef TIM_H
 #define TIM_H
 
+#include "mode.h"
+
+/*** TIM macros ***/
+
+#ifdef MSI_CALIBRATION
+#define TIM21_MSI_CAPTURE_PRESCALER		8 // Number of LSE periods per input capture.
+#endif
+
 /*** TIM structures ***/
 
 // Color bit masks defined as 0b<CH4><CH3><CH2><CH1>
@@ -29,11 +37,18 @@ void TIM2_disable(void);
 void TIM2_set_color_mask(TIM2_channel_mask_t led_color);
 void TIM2_start(void);
 void TIM2_stop(void);
+#ifdef ADC_STREAM
+void TIM2_start_trigger(unsigned int trigger_frequency_hz);
+void TIM2_stop_trigger(void);
+#endif
 
 void TIM21_init(unsigned int led_blink_period_ms);
 void TIM21_disable(void);
 void TIM21_Start(void);
 void TIM21_Stop(void);
 unsigned char TIM21_IsSingleBlinkDone(void);
+#ifdef MSI_CALIBRATION
+unsigned char TIM21_measure_msi(unsigned char number_of_captures, unsigned int* msi_ticks);
+#endif
 
 #endif /* TIM_H */
@@ -31,6 +31,6 @@ typedef struct {
 /*** EEPROM address range ***/
 
 #define EEPROM_START_ADDRESS	(unsigned int) 0x08080000
-#define EEPROM_SIZE				1024 // 1kB for STM32L041xxxx (category 2 device).
+#define EEPROM_SIZE				512 // 512 bytes for STM32L011xxxx (category 1 device).
 
 #endif /* FLASH_REG_H */
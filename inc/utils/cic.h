@@ -0,0 +1,33 @@
+/*
+ * cic.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef CIC_H
+#define CIC_H
+
+/*** CIC macros ***/
+
+#define CIC_ORDER_MAX			4
+#define CIC_GAIN_BITS_MAX		20 // Bit growth limit for 12-bits input samples on 32-bits accumulators.
+#define CIC_RATIO_LOG2_MAX		15 // Decimation counter is 16-bits wide.
+
+/*** CIC structures ***/
+
+typedef struct {
+	unsigned char order;
+	unsigned char ratio_log2;
+	unsigned short sample_count;
+	unsigned int integrator[CIC_ORDER_MAX];
+	unsigned int comb_delay[CIC_ORDER_MAX];
+} CIC_context_t;
+
+/*** CIC functions ***/
+
+void CIC_init(CIC_context_t* cic_ctx, unsigned char order, unsigned char ratio_log2);
+unsigned char CIC_get_gain_bits(CIC_context_t* cic_ctx);
+unsigned char CIC_process(CIC_context_t* cic_ctx, unsigned int sample, unsigned int* output);
+
+#endif /* CIC_H */
@@ -0,0 +1,25 @@
+/*
+ * goertzel.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+
+/*** GOERTZEL structures ***/
+
+typedef struct {
+	int coefficient; // 2*cos(2*pi*f/fs) in Q14 format.
+	int s1;
+	int s2;
+} GOERTZEL_context_t;
+
+/*** GOERTZEL functions ***/
+
+void GOERTZEL_init(GOERTZEL_context_t* goertzel_ctx, unsigned int target_frequency_hz, unsigned int sampling_frequency_hz);
+void GOERTZEL_process(GOERTZEL_context_t* goertzel_ctx, int sample);
+unsigned int GOERTZEL_get_magnitude(GOERTZEL_context_t* goertzel_ctx);
+
+#endif /* GOERTZEL_H */
@@ -13,5 +13,7 @@
 unsigned int MATH_pow_10(unsigned char power);
 unsigned int MATH_average(unsigned int* data, unsigned char data_length);
 unsigned int MATH_median_filter(unsigned int* data, unsigned char median_length, unsigned char average_length);
+unsigned int MATH_sqrt(unsigned long long value);
+unsigned short MATH_crc16(unsigned char* data, unsigned int data_length);
 
 #endif /* MATH_H */
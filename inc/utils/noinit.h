@@ -0,0 +1,38 @@
+/*
+ * noinit.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef NOINIT_H
+#define NOINIT_H
+
+/*** NOINIT structures ***/
+
+typedef enum {
+	NOINIT_RESET_SOURCE_IWDG = 0,
+	NOINIT_RESET_SOURCE_SOFTWARE,
+	NOINIT_RESET_SOURCE_LOW_POWER,
+	NOINIT_RESET_SOURCE_PIN,
+	NOINIT_RESET_SOURCE_LAST
+} NOINIT_reset_source_t;
+
+// Warning: NOINIT_MAGIC must be changed when this structure is modified.
+typedef struct {
+	unsigned int reset_count[NOINIT_RESET_SOURCE_LAST];
+	unsigned int energy_mj;
+	unsigned int energy_remainder_nj;
+} NOINIT_data_t;
+
+/*** NOINIT functions ***/
+
+unsigned char NOINIT_init(void);
+void NOINIT_record_reset(NOINIT_reset_source_t reset_source);
+void NOINIT_add_energy(unsigned int vout_mv, unsigned int iout_ua, unsigned int duration_seconds);
+void NOINIT_get_data(NOINIT_data_t* data);
+void NOINIT_restore_energy(unsigned int energy_mj);
+void NOINIT_clear_reset_counts(void);
+void NOINIT_restore_reset_count(NOINIT_reset_source_t reset_source, unsigned int reset_count);
+
+#endif /* NOINIT_H */
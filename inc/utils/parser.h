@@ -31,6 +31,9 @@ typedef enum {
     PARSER_ERROR_PARAMETER_DEC_INVALID,
     PARSER_ERROR_PARAMETER_DEC_OVERFLOW,
     PARSER_ERROR_PARAMETER_BYTE_ARRAY_INVALID_LENGTH,
+    PARSER_ERROR_PARAMETER_UNIT_INVALID,
+    PARSER_ERROR_PARAMETER_RESOLUTION,
+    PARSER_ERROR_PARAMETER_OUT_OF_RANGE,
 } PARSER_Status;
 
 typedef enum {
@@ -50,6 +53,7 @@ typedef struct {
 
 PARSER_Status PARSER_compare(PARSER_Context* parser_ctx, PARSER_mode_t mode, char* command);
 PARSER_Status PARSER_get_parameter(PARSER_Context* parser_ctx, PARSER_ParameterType param_type, char separator, unsigned char last_param, int* param);
+PARSER_Status PARSER_get_fixed_point_parameter(PARSER_Context* parser_ctx, char separator, unsigned char last_param, char* unit, unsigned char unit_power, int min, int max, int* param);
 PARSER_Status PARSER_get_byte_array(PARSER_Context* parser_ctx, char separator, unsigned char last_param, unsigned char max_length, unsigned char* param, unsigned char* extracted_length);
 
 #endif	/* PARSER_H */
@@ -0,0 +1,111 @@
+/*
+ * host_sim.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ *
+ * Host register trace recorder. Firmware sources are compiled for the host with
+ * volatile accesses instrumented, and run against simulated registers mapped at
+ * their physical addresses. Each cycle prints per register read/write/poll counts.
+ *
+ * Build (x86_64 Linux, from an empty directory next to the sources):
+ *   INC=$(find ../inc -type d | sed 's/^/-iquote /')
+ *   SRC=$(find ../src -name "*.c" ! -name main.c ! -name pwr.c)
+ *   gcc -O1 -c -fsanitize=thread --param tsan-distinguish-volatile=1 --param tsan-instrument-func-entry-exit=0 $INC $SRC
+ *   gcc -O1 $INC ../script/host_sim/host_sim.c ../script/host_sim/trace.c *.o -o host_sim
+ * Usage:
+ *   ./host_sim [-v] > trace.txt
+ *   ../script/host_sim/trace_diff.py trace_before.txt trace_after.txt
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "adc.h"
+#include "exti.h"
+#include "gpio.h"
+#include "iwdg.h"
+#include "lptim.h"
+#include "lpuart.h"
+#include "mapping.h"
+#include "mode.h"
+#include "nvic.h"
+#include "rcc.h"
+#include "rtc.h"
+#include "systick.h"
+#include "trace.h"
+
+/*** HOST_SIM global variables ***/
+
+// Vector table normally provided by the startup file.
+unsigned int __Vectors[64];
+
+/*** HOST_SIM power stubs (WFI is not available on host) ***/
+
+void PWR_init(void) {}
+void PWR_enter_sleep_mode(void) {}
+void PWR_enter_low_power_sleep_mode(void) {}
+void PWR_enter_stop_mode(void) {}
+void PWR_enter_standby_mode(void) {}
+unsigned char PWR_get_standby_flag(void) { return 0; }
+
+/*** HOST_SIM local functions ***/
+
+/* FIRMWARE INIT SEQUENCE (SAME ORDER AS MAIN).
+ * @param:	None.
+ * @return:	None.
+ */
+static void HOST_SIM_init(void) {
+	NVIC_init();
+	SYSTICK_init();
+	RCC_init();
+	RCC_enable_lsi();
+	IWDG_init();
+	GPIO_init();
+	EXTI_init();
+	RTC_reset();
+	RCC_enable_lse();
+	RTC_init();
+#ifdef MSI_CALIBRATION
+	RCC_calibrate_msi(RCC_MSI_CALIBRATION_BOOT_STEPS);
+#endif
+	LPTIM1_init();
+	LPUART1_init();
+	ADC1_init();
+}
+
+/*** HOST_SIM main function ***/
+
+/* MAIN FUNCTION.
+ * @param argc:	Number of arguments.
+ * @param argv:	Arguments ("-v" prints every access).
+ * @return:		0 in case of success, 1 otherwise.
+ */
+int main(int argc, char** argv) {
+	// Map simulated peripherals.
+	if (TRACE_init((argc > 1) && (strcmp(argv[1], "-v") == 0)) == 0) {
+		fprintf(stderr, "host_sim: unable to map peripheral regions\n");
+		return 1;
+	}
+	// Traced cycles.
+	TRACE_start_cycle("init");
+	HOST_SIM_init();
+	TRACE_end_cycle();
+	TRACE_start_cycle("gpio_configure");
+	GPIO_configure(&GPIO_LED_RED, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	TRACE_end_cycle();
+	TRACE_start_cycle("lpuart_enable_rx");
+	LPUART1_enable_rx();
+	TRACE_end_cycle();
+	TRACE_start_cycle("lpuart_send_string");
+	LPUART1_send_string("OK\n");
+	TRACE_end_cycle();
+	TRACE_start_cycle("adc_perform_measurements");
+	ADC1_perform_measurements(ADC_DATA_MASK_ALL);
+	TRACE_end_cycle();
+	TRACE_start_cycle("rtc_wakeup");
+	RTC_restart_wakeup_timer(RTC_WAKEUP_PERIOD_SECONDS);
+	RTC_clear_wakeup_timer_flag();
+	TRACE_end_cycle();
+	return 0;
+}
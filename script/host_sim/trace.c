@@ -0,0 +1,372 @@
+/*
+ * trace.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "trace.h"
+
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include "adc_reg.h"
+#include "exti_reg.h"
+#include "flash_reg.h"
+#include "gpio_reg.h"
+#include "iwdg_reg.h"
+#include "lptim_reg.h"
+#include "lpuart_reg.h"
+#include "nvic_reg.h"
+#include "pwr_reg.h"
+#include "rcc_reg.h"
+#include "rtc_reg.h"
+#include "scb_reg.h"
+#include "syscfg_reg.h"
+#include "systick_reg.h"
+#include "tim_reg.h"
+
+/*** TRACE local macros ***/
+
+#define TRACE_NUMBER_OF_REGISTERS_MAX	256
+#define TRACE_SPIN_READS				32 // Consecutive reads of a RAM flag considered as waiting for an interrupt.
+#define TRACE_CALIBRATION_PAGE			0x1FF80000
+#define TRACE_VREFINT_CAL_VALUE			1670 // Typical factory value at 3V.
+
+/*** TRACE local structures ***/
+
+typedef struct {
+	unsigned long address;
+	unsigned long size;
+} TRACE_region_t;
+
+typedef struct {
+	unsigned long base;
+	unsigned long size;
+	char* name;
+} TRACE_peripheral_t;
+
+// Hardware model: flags set (or bits cleared) after a number of reads following a trigger write.
+typedef struct {
+	volatile unsigned int* reg;
+	volatile unsigned int* trigger;
+	unsigned int set_mask;
+	unsigned int clear_mask;
+	unsigned int delay_reads;
+	unsigned int reads;
+} TRACE_model_t;
+
+typedef struct {
+	unsigned long address;
+	unsigned int reads;
+	unsigned int writes;
+	unsigned int polls;
+	unsigned long long last_read_write_count;
+} TRACE_register_stats_t;
+
+typedef struct {
+	unsigned char verbose;
+	char* cycle_name;
+	unsigned long long timestamp;
+	unsigned long long cycle_start;
+	unsigned long long write_count;
+	unsigned long spin_address;
+	unsigned int spin_reads;
+	unsigned char in_interrupt;
+	TRACE_register_stats_t stats[TRACE_NUMBER_OF_REGISTERS_MAX];
+	unsigned int stats_count;
+} TRACE_context_t;
+
+/*** TRACE external functions ***/
+
+extern void LPTIM1_IRQHandler(void);
+
+/*** TRACE local global variables ***/
+
+static const TRACE_region_t TRACE_REGIONS[] = {
+	{0x08080000, 0x1000}, // Data EEPROM.
+	{TRACE_CALIBRATION_PAGE, 0x1000}, // Factory calibration values.
+	{0x40000000, 0x24000}, // APB and AHB peripherals.
+	{0x50000000, 0x2000}, // IOPORT.
+	{0xE000E000, 0x1000} // Cortex-M0+ private peripherals.
+};
+static const TRACE_peripheral_t TRACE_PERIPHERALS[] = {
+	{0x40000000, 0x400, "TIM2"},
+	{0x40002800, 0x400, "RTC"},
+	{0x40003000, 0x400, "IWDG"},
+	{0x40004800, 0x400, "LPUART1"},
+	{0x40007000, 0x400, "PWR"},
+	{0x40007C00, 0x400, "LPTIM1"},
+	{0x40010000, 0x400, "SYSCFG"},
+	{0x40010400, 0x400, "EXTI"},
+	{0x40010800, 0x400, "TIM21"},
+	{0x40012400, 0x400, "ADC1"},
+	{0x40021000, 0x400, "RCC"},
+	{0x40022000, 0x400, "FLASH"},
+	{0x50000000, 0x400, "GPIOA"},
+	{0x50000400, 0x400, "GPIOB"},
+	{0x50000800, 0x400, "GPIOC"},
+	{0xE000E010, 0x10, "SYSTICK"},
+	{0xE000E100, 0x400, "NVIC"},
+	{0xE000ED00, 0x100, "SCB"},
+	{0x08080000, 0x1000, "EEPROM"},
+	{TRACE_CALIBRATION_PAGE, 0x1000, "CAL"}
+};
+static TRACE_model_t trace_model[16];
+static unsigned int trace_model_count = 0;
+static TRACE_context_t trace_ctx;
+
+/*** TRACE local functions ***/
+
+/* ADD A HARDWARE MODEL ENTRY.
+ * @param reg:			Modelled register.
+ * @param trigger:		Register whose write (like a write to reg) restarts the delay.
+ * @param set_mask:		Bits set once the delay elapsed (cleared before).
+ * @param clear_mask:	Bits cleared once the delay elapsed.
+ * @param delay_reads:	Number of reads of reg before the event occurs.
+ * @return:				None.
+ */
+static void TRACE_add_model(volatile unsigned int* reg, volatile unsigned int* trigger, unsigned int set_mask, unsigned int clear_mask, unsigned int delay_reads) {
+	trace_model[trace_model_count].reg = reg;
+	trace_model[trace_model_count].trigger = trigger;
+	trace_model[trace_model_count].reads = 0;
+	trace_model[trace_model_count].set_mask = set_mask;
+	trace_model[trace_model_count].clear_mask = clear_mask;
+	trace_model[trace_model_count].delay_reads = delay_reads;
+	trace_model_count++;
+}
+
+/* GET THE PERIPHERAL CONTAINING AN ADDRESS.
+ * @param address:	Accessed address.
+ * @return:			Peripheral descriptor, 0 if the address is not a register.
+ */
+static const TRACE_peripheral_t* TRACE_get_peripheral(unsigned long address) {
+	// Local variables.
+	unsigned int idx = 0;
+	for (idx=0 ; idx<(sizeof(TRACE_PERIPHERALS) / sizeof(TRACE_peripheral_t)) ; idx++) {
+		if ((address >= TRACE_PERIPHERALS[idx].base) && (address < (TRACE_PERIPHERALS[idx].base + TRACE_PERIPHERALS[idx].size))) {
+			return &(TRACE_PERIPHERALS[idx]);
+		}
+	}
+	return 0;
+}
+
+/* GET STATISTICS ENTRY OF A REGISTER.
+ * @param address:	Register address.
+ * @return:			Statistics entry.
+ */
+static TRACE_register_stats_t* TRACE_get_stats(unsigned long address) {
+	// Local variables.
+	unsigned int idx = 0;
+	for (idx=0 ; idx<trace_ctx.stats_count ; idx++) {
+		if (trace_ctx.stats[idx].address == address) return &(trace_ctx.stats[idx]);
+	}
+	// Use last entry as overflow bucket.
+	if (trace_ctx.stats_count < TRACE_NUMBER_OF_REGISTERS_MAX) {
+		trace_ctx.stats_count++;
+	}
+	idx = trace_ctx.stats_count - 1;
+	if (trace_ctx.stats[idx].address != address) {
+		trace_ctx.stats[idx].address = address;
+		trace_ctx.stats[idx].reads = 0;
+		trace_ctx.stats[idx].writes = 0;
+		trace_ctx.stats[idx].polls = 0;
+		trace_ctx.stats[idx].last_read_write_count = 0;
+	}
+	return &(trace_ctx.stats[idx]);
+}
+
+/* APPLY HARDWARE MODEL ON A REGISTER ACCESS.
+ * @param address:	Register address.
+ * @param write:	0 for a read, 1 for a write.
+ * @return:			None.
+ */
+static void TRACE_apply_model(unsigned long address, unsigned char write) {
+	// Local variables.
+	unsigned int idx = 0;
+	for (idx=0 ; idx<trace_model_count ; idx++) {
+		// Restart delay on trigger.
+		if (write != 0) {
+			if (((unsigned long) trace_model[idx].reg == address) || ((unsigned long) trace_model[idx].trigger == address)) {
+				trace_model[idx].reads = 0;
+			}
+			continue;
+		}
+		if ((unsigned long) trace_model[idx].reg != address) continue;
+		trace_model[idx].reads++;
+		if (trace_model[idx].reads >= trace_model[idx].delay_reads) {
+			(*trace_model[idx].reg) |= trace_model[idx].set_mask;
+			(*trace_model[idx].reg) &= ~trace_model[idx].clear_mask;
+		}
+		else {
+			(*trace_model[idx].reg) &= ~trace_model[idx].set_mask;
+		}
+	}
+}
+
+/* DELIVER MODELLED INTERRUPTS WHILE SOFTWARE SPINS ON A RAM FLAG.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TRACE_fire_interrupts(void) {
+	trace_ctx.in_interrupt = 1;
+	// LPTIM1 auto-reload match.
+	if ((((NVIC -> ISER) & (0b1 << 13)) != 0) && (((LPTIM1 -> IER) & (0b1 << 1)) != 0)) {
+		LPTIM1 -> ISR |= (0b1 << 1);
+		LPTIM1_IRQHandler();
+	}
+	trace_ctx.in_interrupt = 0;
+}
+
+/* RECORD A VOLATILE ACCESS.
+ * @param address:	Accessed address.
+ * @param write:	0 for a read, 1 for a write.
+ * @return:			None.
+ */
+static void TRACE_record(unsigned long address, unsigned char write) {
+	// Local variables.
+	const TRACE_peripheral_t* peripheral = TRACE_get_peripheral(address);
+	TRACE_register_stats_t* stats = 0;
+	unsigned char poll = 0;
+	// Detect busy waits on RAM flags.
+	if (peripheral == 0) {
+		if ((write == 0) && (trace_ctx.in_interrupt == 0)) {
+			trace_ctx.spin_reads = (address == trace_ctx.spin_address) ? (trace_ctx.spin_reads + 1) : 1;
+			trace_ctx.spin_address = address;
+			if (trace_ctx.spin_reads >= TRACE_SPIN_READS) {
+				trace_ctx.spin_reads = 0;
+				TRACE_fire_interrupts();
+			}
+		}
+		return;
+	}
+	trace_ctx.timestamp++;
+	TRACE_apply_model(address, write);
+	// Update statistics.
+	stats = TRACE_get_stats(address);
+	if (write != 0) {
+		stats -> writes++;
+		trace_ctx.write_count++;
+	}
+	else {
+		// Reading again a register without any write meanwhile is a polling iteration.
+		poll = ((stats -> last_read_write_count) == (trace_ctx.write_count + 1));
+		(stats -> last_read_write_count) = (trace_ctx.write_count + 1);
+		if (poll != 0) {
+			stats -> polls++;
+		}
+		else {
+			stats -> reads++;
+		}
+	}
+	if (trace_ctx.verbose != 0) {
+		printf("T %llu %c %s+0x%03lX\n", trace_ctx.timestamp - trace_ctx.cycle_start, (write != 0) ? 'W' : ((poll != 0) ? 'P' : 'R'), peripheral -> name, address - (peripheral -> base));
+	}
+}
+
+/*** TRACE instrumentation hooks (-fsanitize=thread --param tsan-distinguish-volatile=1) ***/
+
+void __tsan_init(void) {}
+void __tsan_volatile_read1(void* address) {TRACE_record((unsigned long) address, 0);}
+void __tsan_volatile_read2(void* address) {TRACE_record((unsigned long) address, 0);}
+void __tsan_volatile_read4(void* address) {TRACE_record((unsigned long) address, 0);}
+void __tsan_volatile_read8(void* address) {TRACE_record((unsigned long) address, 0);}
+void __tsan_volatile_read16(void* address) {TRACE_record((unsigned long) address, 0);}
+void __tsan_volatile_write1(void* address) {TRACE_record((unsigned long) address, 1);}
+void __tsan_volatile_write2(void* address) {TRACE_record((unsigned long) address, 1);}
+void __tsan_volatile_write4(void* address) {TRACE_record((unsigned long) address, 1);}
+void __tsan_volatile_write8(void* address) {TRACE_record((unsigned long) address, 1);}
+void __tsan_volatile_write16(void* address) {TRACE_record((unsigned long) address, 1);}
+// Plain memory accesses are not traced.
+void __tsan_read1(void* address) {(void) address;}
+void __tsan_read2(void* address) {(void) address;}
+void __tsan_read4(void* address) {(void) address;}
+void __tsan_read8(void* address) {(void) address;}
+void __tsan_read16(void* address) {(void) address;}
+void __tsan_write1(void* address) {(void) address;}
+void __tsan_write2(void* address) {(void) address;}
+void __tsan_write4(void* address) {(void) address;}
+void __tsan_write8(void* address) {(void) address;}
+void __tsan_write16(void* address) {(void) address;}
+void __tsan_unaligned_read2(void* address) {(void) address;}
+void __tsan_unaligned_read4(void* address) {(void) address;}
+void __tsan_unaligned_read8(void* address) {(void) address;}
+void __tsan_unaligned_read16(void* address) {(void) address;}
+void __tsan_unaligned_write2(void* address) {(void) address;}
+void __tsan_unaligned_write4(void* address) {(void) address;}
+void __tsan_unaligned_write8(void* address) {(void) address;}
+void __tsan_unaligned_write16(void* address) {(void) address;}
+void __tsan_read_range(void* address, unsigned long size) {(void) address; (void) size;}
+void __tsan_write_range(void* address, unsigned long size) {(void) address; (void) size;}
+void __tsan_func_entry(void* caller) {(void) caller;}
+void __tsan_func_exit(void) {}
+
+/*** TRACE functions ***/
+
+/* MAP SIMULATED PERIPHERALS AND INIT HARDWARE MODEL.
+ * @param verbose:	Print every access if non zero.
+ * @return:			1 in case of success, 0 otherwise.
+ */
+unsigned char TRACE_init(unsigned char verbose) {
+	// Local variables.
+	unsigned int idx = 0;
+	void* region = 0;
+	// Map register regions at their physical addresses.
+	for (idx=0 ; idx<(sizeof(TRACE_REGIONS) / sizeof(TRACE_region_t)) ; idx++) {
+		region = mmap((void*) TRACE_REGIONS[idx].address, TRACE_REGIONS[idx].size, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (region != (void*) TRACE_REGIONS[idx].address) return 0;
+	}
+	(*VREFINT_CAL_ADDR) = TRACE_VREFINT_CAL_VALUE;
+	// Hardware model.
+	TRACE_add_model(&(LPUART1 -> ISR), &(LPUART1 -> TDR), (0b1 << 7) | (0b1 << 6), 0, 4); // TXE and TC.
+	TRACE_add_model(&(ADC1 -> ISR), &(ADC1 -> CR), (0b1 << 11) | (0b1 << 2) | (0b1 << 0), 0, 4); // EOCAL, EOC and ADRDY.
+	TRACE_add_model(&(ADC1 -> CR), &(ADC1 -> CR), 0, (0b1 << 31) | (0b1 << 4) | (0b1 << 1), 4); // ADCAL, ADSTP and ADDIS.
+	TRACE_add_model(&(LPTIM1 -> ISR), &(LPTIM1 -> ARR), (0b1 << 4), 0, 2); // ARROK.
+	TRACE_add_model(&(RCC -> CR), &(RCC -> CR), (0b1 << 9) | (0b1 << 2), 0, 2); // MSIRDY and HSI16RDYF.
+	TRACE_add_model(&(RCC -> CSR), &(RCC -> CSR), (0b1 << 9) | (0b1 << 1), 0, 2); // LSERDY and LSIRDY.
+	TRACE_add_model(&(RTC -> ISR), &(RTC -> ISR), (0b1 << 6) | (0b1 << 5) | (0b1 << 2), 0, 2); // INITF, RSF and WUTWF.
+	TRACE_add_model(&(TIM21 -> SR), &(TIM21 -> SR), (0b1 << 1), 0, 4); // CC1IF.
+	// Init context.
+	trace_ctx.verbose = verbose;
+	trace_ctx.cycle_name = "none";
+	trace_ctx.timestamp = 0;
+	trace_ctx.write_count = 0;
+	trace_ctx.stats_count = 0;
+	return 1;
+}
+
+/* START A NEW TRACED CYCLE.
+ * @param name:	Cycle name.
+ * @return:		None.
+ */
+void TRACE_start_cycle(char* name) {
+	trace_ctx.cycle_name = name;
+	trace_ctx.cycle_start = trace_ctx.timestamp;
+	trace_ctx.stats_count = 0;
+	if (trace_ctx.verbose != 0) {
+		printf("# %s\n", name);
+	}
+}
+
+/* PRINT STATISTICS OF THE CURRENT CYCLE.
+ * @param:	None.
+ * @return:	None.
+ */
+void TRACE_end_cycle(void) {
+	// Local variables.
+	unsigned int idx = 0;
+	unsigned int reads = 0;
+	unsigned int writes = 0;
+	unsigned int polls = 0;
+	const TRACE_peripheral_t* peripheral = 0;
+	// Per register counts.
+	for (idx=0 ; idx<trace_ctx.stats_count ; idx++) {
+		peripheral = TRACE_get_peripheral(trace_ctx.stats[idx].address);
+		printf("REG %s %s+0x%03lX %u %u %u\n", trace_ctx.cycle_name, peripheral -> name, trace_ctx.stats[idx].address - (peripheral -> base), trace_ctx.stats[idx].reads, trace_ctx.stats[idx].writes, trace_ctx.stats[idx].polls);
+		reads += trace_ctx.stats[idx].reads;
+		writes += trace_ctx.stats[idx].writes;
+		polls += trace_ctx.stats[idx].polls;
+	}
+	// Cycle totals.
+	printf("CYCLE %s %u %u %u %llu\n", trace_ctx.cycle_name, reads, writes, polls, trace_ctx.timestamp - trace_ctx.cycle_start);
+}
@@ -0,0 +1,17 @@
+/*
+ * trace.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/*** TRACE functions ***/
+
+unsigned char TRACE_init(unsigned char verbose);
+void TRACE_start_cycle(char* name);
+void TRACE_end_cycle(void);
+
+#endif /* TRACE_H */
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+#
+# trace_diff.py
+#
+#  Created on: 19 oct. 2026
+#      Author: Ludo
+#
+# Compare register traffic of two host_sim traces.
+# Usage: trace_diff.py <reference_trace> <new_trace>
+# Exit code is 1 if reads, writes or polls increased in any cycle.
+
+import sys
+
+FIELDS = ("reads", "writes", "polls")
+
+def parse_trace(file_name):
+    cycles = {}
+    registers = {}
+    with open(file_name) as trace:
+        for line in trace:
+            items = line.split()
+            if (len(items) == 6) and (items[0] == "CYCLE"):
+                cycles[items[1]] = [int(value) for value in items[2:5]]
+            elif (len(items) == 6) and (items[0] == "REG"):
+                registers[(items[1], items[2])] = [int(value) for value in items[3:6]]
+    return cycles, registers
+
+def format_delta(reference, new):
+    return "%d -> %d (%+d)" % (reference, new, new - reference)
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: trace_diff.py <reference_trace> <new_trace>")
+        return 2
+    reference_cycles, reference_registers = parse_trace(sys.argv[1])
+    new_cycles, new_registers = parse_trace(sys.argv[2])
+    increased = False
+    # Cycle totals.
+    for cycle in sorted(set(reference_cycles) | set(new_cycles)):
+        reference = reference_cycles.get(cycle, [0, 0, 0])
+        new = new_cycles.get(cycle, [0, 0, 0])
+        if reference == new:
+            continue
+        print("%s: %s" % (cycle, ", ".join("%s %s" % (FIELDS[idx], format_delta(reference[idx], new[idx])) for idx in range(len(FIELDS)))))
+        increased |= any(new[idx] > reference[idx] for idx in range(len(FIELDS)))
+        # Registers responsible for the difference.
+        for key in sorted(set(reference_registers) | set(new_registers)):
+            if key[0] != cycle:
+                continue
+            reference_register = reference_registers.get(key, [0, 0, 0])
+            new_register = new_registers.get(key, [0, 0, 0])
+            if reference_register != new_register:
+                print("    %s: %s" % (key[1], ", ".join("%s %s" % (FIELDS[idx], format_delta(reference_register[idx], new_register[idx])) for idx in range(len(FIELDS)) if reference_register[idx] != new_register[idx])))
+    return 1 if increased else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
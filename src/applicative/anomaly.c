@@ -0,0 +1,213 @@
+/*
+ * anomaly.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "anomaly.h"
+
+#include "mode.h"
+
+#ifdef ANOMALY_DETECTION
+/*** ANOMALY local macros ***/
+
+#define ANOMALY_BUCKET_DURATION_SECONDS	(86400 / ANOMALY_NUMBER_OF_BUCKETS) // 3 hours.
+#define ANOMALY_EWMA_SHIFT				6 // Smoothing factor 1/64.
+#define ANOMALY_LEARNING_SAMPLES		64 // Samples required in a bucket before flagging.
+#define ANOMALY_SIGMA_MIN_UA			5000 // Floor of the standard deviation (ADC resolution and noise).
+#define ANOMALY_COUNTER_MAX				0x7F // Keeps the status word positive.
+#define ANOMALY_OFFSET_EWMA_SHIFT		3 // Smoothing factor 1/8.
+#define ANOMALY_LEAKAGE_VOUT_MV			500 // Output voltage above which an open relay is leaking.
+#define ANOMALY_LEAKAGE_IOUT_UA			20000 // Raw output current above which the offset can not be explained by the sensor.
+
+/*** ANOMALY local structures ***/
+
+typedef struct {
+	ANOMALY_baseline_t baseline[ANOMALY_NUMBER_OF_BUCKETS];
+	unsigned char sigma_threshold;
+	unsigned int status;
+	int iout_offset_ua;
+	unsigned char iout_offset_learned;
+} ANOMALY_context_t;
+
+/*** ANOMALY local global variables ***/
+
+static ANOMALY_context_t anomaly_ctx;
+
+/*** ANOMALY local functions ***/
+
+/* INCREMENT A SATURATED 8-BITS FIELD OF THE STATUS WORD.
+ * @param shift:	Position of the field.
+ * @return:			None.
+ */
+static void ANOMALY_increment_counter(unsigned char shift) {
+	if (((anomaly_ctx.status >> shift) & ANOMALY_COUNTER_MAX) < ANOMALY_COUNTER_MAX) {
+		anomaly_ctx.status += (0b1 << shift);
+	}
+}
+
+/*** ANOMALY functions ***/
+
+/* INIT ANOMALY DETECTOR.
+ * @param:	None.
+ * @return:	None.
+ */
+void ANOMALY_init(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Reset all baselines.
+	for (idx=0 ; idx<ANOMALY_NUMBER_OF_BUCKETS ; idx++) {
+		anomaly_ctx.baseline[idx].mean_ua = 0;
+		anomaly_ctx.baseline[idx].variance_ua2 = 0;
+		anomaly_ctx.baseline[idx].sample_count = 0;
+	}
+	anomaly_ctx.sigma_threshold = ANOMALY_SIGMA_THRESHOLD_DEFAULT;
+	anomaly_ctx.status = 0;
+	anomaly_ctx.iout_offset_ua = 0;
+	anomaly_ctx.iout_offset_learned = 0;
+}
+
+/* SET ANOMALY THRESHOLD.
+ * @param sigma_threshold:	Number of standard deviations above which a sample is anomalous.
+ * @return:					None.
+ */
+void ANOMALY_set_sigma_threshold(unsigned char sigma_threshold) {
+	if ((sigma_threshold > 0) && (sigma_threshold <= ANOMALY_SIGMA_THRESHOLD_MAX)) {
+		anomaly_ctx.sigma_threshold = sigma_threshold;
+	}
+}
+
+/* GET ANOMALY THRESHOLD.
+ * @param:	None.
+ * @return:	Number of standard deviations above which a sample is anomalous.
+ */
+unsigned char ANOMALY_get_sigma_threshold(void) {
+	return anomaly_ctx.sigma_threshold;
+}
+
+/* CHECK A NEW OUTPUT CURRENT SAMPLE AND UPDATE BASELINE.
+ * @param iout_ua:				Output current in uA.
+ * @param timestamp_seconds:	Sample timestamp, used to select the time-of-day bucket.
+ * @return:						1 if the sample deviates from the baseline, 0 otherwise.
+ */
+unsigned char ANOMALY_process(unsigned int iout_ua, unsigned int timestamp_seconds) {
+	// Local variables.
+	unsigned char bucket_idx = ((timestamp_seconds % 86400) / ANOMALY_BUCKET_DURATION_SECONDS);
+	ANOMALY_baseline_t* baseline = &(anomaly_ctx.baseline[bucket_idx]);
+	int delta_ua = ((int) iout_ua) - (baseline -> mean_ua);
+	unsigned long long delta_ua2 = ((long long) delta_ua) * delta_ua;
+	unsigned long long variance_ua2 = (baseline -> variance_ua2);
+	unsigned char anomaly = 0;
+	// Update bucket and learning flag.
+	anomaly_ctx.status &= ~((0b1111 << ANOMALY_STATUS_SHIFT_BUCKET) | (0b1 << ANOMALY_STATUS_BIT_LEARNED) | (0b1 << ANOMALY_STATUS_BIT_LAST));
+	anomaly_ctx.status |= (bucket_idx << ANOMALY_STATUS_SHIFT_BUCKET);
+	// First sample initializes the bucket mean.
+	if ((baseline -> sample_count) == 0) {
+		(baseline -> mean_ua) = (int) iout_ua;
+		(baseline -> sample_count)++;
+		return 0;
+	}
+	// Compare deviation to threshold once the baseline is learned (compare squares to avoid square root).
+	if ((baseline -> sample_count) >= ANOMALY_LEARNING_SAMPLES) {
+		anomaly_ctx.status |= (0b1 << ANOMALY_STATUS_BIT_LEARNED);
+		if (variance_ua2 < ((unsigned long long) ANOMALY_SIGMA_MIN_UA * ANOMALY_SIGMA_MIN_UA)) {
+			variance_ua2 = ((unsigned long long) ANOMALY_SIGMA_MIN_UA * ANOMALY_SIGMA_MIN_UA);
+		}
+		if (delta_ua2 > (variance_ua2 * anomaly_ctx.sigma_threshold * anomaly_ctx.sigma_threshold)) {
+			anomaly = 1;
+		}
+	}
+	else {
+		(baseline -> sample_count)++;
+	}
+	// Update status word.
+	if (anomaly != 0) {
+		anomaly_ctx.status |= (0b1 << ANOMALY_STATUS_BIT_LAST);
+		anomaly_ctx.status &= ~(0b1 << ANOMALY_STATUS_BIT_LAST_HIGH);
+		if (delta_ua > 0) {
+			anomaly_ctx.status |= (0b1 << ANOMALY_STATUS_BIT_LAST_HIGH);
+			ANOMALY_increment_counter(ANOMALY_STATUS_SHIFT_HIGH_COUNT);
+		}
+		else {
+			ANOMALY_increment_counter(ANOMALY_STATUS_SHIFT_LOW_COUNT);
+		}
+		ANOMALY_increment_counter(ANOMALY_STATUS_SHIFT_CONSECUTIVE);
+	}
+	else {
+		anomaly_ctx.status &= ~(ANOMALY_COUNTER_MAX << ANOMALY_STATUS_SHIFT_CONSECUTIVE);
+	}
+	// Update EWMA of mean and variance: var = (1 - a) * (var + a * delta^2).
+	(baseline -> mean_ua) += (delta_ua >> ANOMALY_EWMA_SHIFT);
+	variance_ua2 = (baseline -> variance_ua2) + (delta_ua2 >> ANOMALY_EWMA_SHIFT);
+	(baseline -> variance_ua2) = variance_ua2 - (variance_ua2 >> ANOMALY_EWMA_SHIFT);
+	return anomaly;
+}
+
+/* CHECK OUTPUT WHILE RELAY IS OPEN AND LEARN CURRENT SENSOR OFFSET.
+ * @param iout_ua:	Raw output current in uA.
+ * @param vout_mv:	Output voltage in mV.
+ * @return:			None.
+ */
+void ANOMALY_process_idle(unsigned int iout_ua, unsigned int vout_mv) {
+	// Any significant output while open means the relay is stuck or bypassed.
+	if ((vout_mv > ANOMALY_LEAKAGE_VOUT_MV) || (iout_ua > ANOMALY_LEAKAGE_IOUT_UA)) {
+		anomaly_ctx.status |= (0b1 << ANOMALY_STATUS_BIT_LEAKAGE);
+		return;
+	}
+	anomaly_ctx.status &= ~(0b1 << ANOMALY_STATUS_BIT_LEAKAGE);
+	// No load current can flow: remaining measurement is the sensor offset.
+	if (anomaly_ctx.iout_offset_learned == 0) {
+		anomaly_ctx.iout_offset_ua = (int) iout_ua;
+		anomaly_ctx.iout_offset_learned = 1;
+	}
+	else {
+		anomaly_ctx.iout_offset_ua += ((((int) iout_ua) - anomaly_ctx.iout_offset_ua) >> ANOMALY_OFFSET_EWMA_SHIFT);
+	}
+}
+
+/* GET LEARNED OUTPUT CURRENT OFFSET.
+ * @param:	None.
+ * @return:	Current sensor offset in uA (0 until learned).
+ */
+unsigned int ANOMALY_get_iout_offset(void) {
+	return (unsigned int) anomaly_ctx.iout_offset_ua;
+}
+
+/* RESTORE OUTPUT CURRENT OFFSET LEARNED BEFORE A RESET.
+ * @param iout_offset_ua:	Current sensor offset in uA.
+ * @return:					None.
+ */
+void ANOMALY_set_iout_offset(unsigned int iout_offset_ua) {
+	anomaly_ctx.iout_offset_ua = (int) iout_offset_ua;
+	anomaly_ctx.iout_offset_learned = 1;
+}
+
+/* GET ANOMALY STATUS WORD.
+ * @param:	None.
+ * @return:	Status word (see ANOMALY_STATUS_* fields).
+ */
+unsigned int ANOMALY_get_status(void) {
+	return anomaly_ctx.status;
+}
+
+/* RESET ANOMALY COUNTERS (BASELINES ARE KEPT).
+ * @param:	None.
+ * @return:	None.
+ */
+void ANOMALY_clear_counters(void) {
+	anomaly_ctx.status &= 0x000000FF; // Reset consecutive, high and low counters.
+}
+
+/* COPY RAW BASELINES TABLE (FOR BULK READ).
+ * @param baseline:	Table of ANOMALY_NUMBER_OF_BUCKETS elements that will contain the baselines.
+ * @return:			None.
+ */
+void ANOMALY_get_baselines(ANOMALY_baseline_t* baseline) {
+	// Local variables.
+	unsigned char idx = 0;
+	for (idx=0 ; idx<ANOMALY_NUMBER_OF_BUCKETS ; idx++) {
+		baseline[idx] = anomaly_ctx.baseline[idx];
+	}
+}
+#endif
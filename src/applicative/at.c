@@ -8,15 +8,25 @@
 #include "at.h"
 
 #include "adc.h"
+#include "anomaly.h"
+#include "boot.h"
+#include "cic.h"
 #include "flash_reg.h"
+#include "governor.h"
+#include "iwdg.h"
 #include "led.h"
 #include "lpuart.h"
 #include "lptim.h"
 #include "mapping.h"
 #include "math.h"
+#include "mode.h"
+#include "noinit.h"
+#include "nvm.h"
 #include "nvic.h"
 #include "parser.h"
 #include "relay.h"
+#include "rtc.h"
+#include "storage.h"
 #include "string.h"
 #include "tim.h"
 #include "usart.h"
@@ -28,19 +38,104 @@
 #define AT_COMMAND_BUFFER_LENGTH		128
 #define AT_RESPONSE_BUFFER_LENGTH		128
 #define AT_STRING_VALUE_BUFFER_LENGTH	16
+#ifdef BULK_TRANSFER
+// Chunked transfer (a 16 bytes chunk is sent as 33 characters which last 34ms at 9600 bauds).
+#define AT_TRANSFER_CHUNK_LENGTH_BYTES	16
+#define AT_TRANSFER_GAP_MS				20
+#define AT_TRANSFER_COMMAND_GAPS_MAX	10
+// Bulk read (2 characters per byte in response).
+#define AT_BULK_LENGTH_MAX_BYTES		40
+#endif
+#ifdef ALARM_PUSH
+// Alarm push frame (ALM,<node>,<alarms>).
+#define AT_ALARM_FRAME_LENGTH			16
+#endif
+#ifdef DIAGNOSTICS
+// Diagnostics record (<version><type><length><value>...<crc>, printed in hexadecimal).
+#define AT_DIAGNOSTICS_VERSION			1
+#define AT_DIAGNOSTICS_LENGTH_MAX_BYTES	62 // 124 characters and LF must fit in the response buffer.
+#endif
+// Pre-serialized status frame (<vin>,<vout>,<iout>,<vmcu>,<relay>,<anomaly>,<timestamp>,<crc>).
+#define AT_STATUS_FRAME_LENGTH			64
 // Input commands without parameter.
 #define AT_COMMAND_TEST					"AT"
 #define AT_COMMAND_INFO					"ATI?"
+#define AT_COMMAND_ADC_SNAPSHOT			"AT$ADC?"
+#ifdef RETAINED_DATA
+#define AT_COMMAND_NOINIT				"AT$NOI?"
+#endif
+#define AT_COMMAND_STATUS				"AT$STS?"
+#ifdef ANOMALY_DETECTION
+#define AT_COMMAND_ANOMALY_STATUS		"AT$ANO?"
+#define AT_COMMAND_ANOMALY_CLEAR		"AT$ANC"
+#endif
+#ifdef ENERGY_GOVERNOR
+#define AT_COMMAND_GOVERNOR				"AT$GOV?"
+#endif
+#ifdef BULK_TRANSFER
+#define AT_COMMAND_TRANSFER				"AT$XFR?"
+#endif
+#ifdef ALARM_PUSH
+#define AT_COMMAND_ALARM				"AT$ALM?"
+#endif
+#ifdef STORAGE_MODE
+#define AT_COMMAND_STORAGE				"AT$STO?"
+#endif
+#ifdef BOOT_PROFILE
+#define AT_COMMAND_BOOT					"AT$BOT?"
+#endif
 // Input commands with parameters (headers).
 #define AT_HEADER_ADC					"AT$ADC="
 #define AT_HEADER_OUT					"AT$OUT="
+#define AT_HEADER_LED					"AT$LED="
+#ifdef ANOMALY_DETECTION
+#define AT_HEADER_ANOMALY				"AT$ANO="
+#endif
+#ifdef ENERGY_GOVERNOR
+#define AT_HEADER_GOVERNOR				"AT$GOV="
+#endif
+#ifdef BULK_TRANSFER
+#define AT_HEADER_TRANSFER				"AT$XFR="
+#define AT_HEADER_BULK_SIZE				"AT$BLS="
+#define AT_HEADER_BULK_READ				"AT$BLK="
+#define AT_HEADER_BULK_TRANSFER			"AT$BLT="
+#endif
+#ifdef ALARM_PUSH
+#define AT_HEADER_ALARM					"AT$ALM="
+#endif
+#ifdef STORAGE_MODE
+#define AT_HEADER_STORAGE				"AT$STO="
+#endif
+#ifdef DIAGNOSTICS
+#define AT_HEADER_DIAGNOSTICS			"AT$DIA="
+#endif
+#ifdef ADC_STREAM
+#define AT_HEADER_CIC					"AT$CIC="
+#define AT_HEADER_RIPPLE_FREQUENCY		"AT$RPF="
+#define AT_HEADER_RIPPLE				"AT$RPL="
+#endif
+#ifdef IRQ_STATS
+#define AT_HEADER_IRQ					"AT$IRQ="
+#endif
 // Parameters separator.
 #define AT_CHAR_SEPARATOR				','
+// Parameters units.
+#ifdef ENERGY_GOVERNOR
+#define AT_UNIT_CURRENT					"A"
+#define AT_UNIT_POWER_UA				6
+#define AT_PARAMETER_MAX				0x7FFFFFFF
+#endif
+#ifdef ADC_STREAM
+#define AT_UNIT_FREQUENCY				"Hz"
+#endif
 // Responses.
 #define AT_RESPONSE_OK					"OK"
 #define AT_RESPONSE_END					"\n"
 #define AT_RESPONSE_ERROR_PSR			"PSR_ERROR_"
 #define AT_RESPONSE_ERROR_APP			"APP_ERROR_"
+#ifdef ALARM_PUSH
+#define AT_RESPONSE_ALARM				"ALM,"
+#endif
 
 /*** AT local structures ***/
 
@@ -49,6 +144,76 @@ typedef enum {
 	AT_ERROR_SOURCE_PERIPHERAL
 } AT_error_source_t;
 
+#ifdef BULK_TRANSFER
+typedef enum {
+	AT_TRANSFER_STATE_IDLE = 0,
+	AT_TRANSFER_STATE_RUNNING,
+	AT_TRANSFER_STATE_PAUSED
+} AT_transfer_state_t;
+
+typedef enum {
+	AT_TRANSFER_ACTION_ABORT = 0,
+	AT_TRANSFER_ACTION_PAUSE,
+	AT_TRANSFER_ACTION_RESUME
+} AT_transfer_action_t;
+
+typedef enum {
+	AT_BULK_OBJECT_NOINIT = 0,
+	AT_BULK_OBJECT_ANOMALY,
+	AT_BULK_OBJECT_EEPROM,
+	AT_BULK_OBJECT_LAST
+} AT_bulk_object_t;
+
+#if (defined RETAINED_DATA) || (defined ANOMALY_DETECTION)
+typedef union {
+#ifdef RETAINED_DATA
+	NOINIT_data_t noinit;
+#endif
+#ifdef ANOMALY_DETECTION
+	ANOMALY_baseline_t baseline[ANOMALY_NUMBER_OF_BUCKETS];
+#endif
+} AT_bulk_copy_t;
+#endif
+
+typedef struct {
+#if (defined RETAINED_DATA) || (defined ANOMALY_DETECTION)
+	AT_bulk_copy_t copy;
+#endif
+	unsigned char* data; // Frozen copy, or EEPROM which is only modified on request.
+	unsigned int size;
+	AT_bulk_object_t object;
+	unsigned char generation;
+} AT_bulk_snapshot_t;
+
+typedef struct {
+	unsigned char* data;
+	unsigned int length;
+	unsigned int offset;
+	AT_transfer_state_t state;
+} AT_transfer_t;
+#endif
+
+#ifdef DIAGNOSTICS
+// Warning: existing types must never be renumbered, new ones are appended.
+typedef enum {
+	AT_DIAGNOSTICS_TYPE_RESET_COUNTS = 1,
+	AT_DIAGNOSTICS_TYPE_ENERGY,
+	AT_DIAGNOSTICS_TYPE_GOVERNOR,
+	AT_DIAGNOSTICS_TYPE_ANOMALY,
+	AT_DIAGNOSTICS_TYPE_ALARMS,
+	AT_DIAGNOSTICS_TYPE_STANDBY_COUNT,
+	AT_DIAGNOSTICS_TYPE_UPTIME,
+	AT_DIAGNOSTICS_TYPE_NVM_ERRORS,
+	AT_DIAGNOSTICS_TYPE_RESIDENCY
+} AT_diagnostics_type_t;
+
+typedef struct {
+	unsigned char data[AT_DIAGNOSTICS_LENGTH_MAX_BYTES];
+	unsigned char length;
+	unsigned char overflow;
+} AT_diagnostics_t;
+#endif
+
 typedef struct {
 	// AT command buffer.
 	volatile unsigned char at_command_buf[AT_COMMAND_BUFFER_LENGTH];
@@ -59,9 +224,43 @@ typedef struct {
 	unsigned int at_response_buf_idx;
 } AT_context_t;
 
+#ifdef ALARM_PUSH
+typedef struct {
+	unsigned char enable;
+	unsigned char alarms;
+	unsigned char pending;
+} AT_alarm_context_t;
+#endif
+
+typedef struct {
+	unsigned char data[AT_STATUS_FRAME_LENGTH];
+	unsigned int length;
+	// Sources of the current frame.
+	unsigned char valid;
+	unsigned int adc_sequence;
+	unsigned char relay_state;
+	unsigned int anomaly_status;
+} AT_status_frame_t;
+
 /*** AT local global variables ***/
 
 static AT_context_t at_ctx;
+#ifdef ADC_STREAM
+// Ripple analysis frequencies, kept across commands.
+static unsigned int at_ripple_frequencies_hz[ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX] = {100, 200, 300, 400};
+#endif
+#ifdef BULK_TRANSFER
+// Chunked transfer, kept across commands.
+static AT_transfer_t at_transfer;
+// Bulk read object frozen by the size command.
+static AT_bulk_snapshot_t at_bulk;
+#endif
+// Status response, rebuilt after each acquisition or state change.
+static AT_status_frame_t at_status_frame;
+#ifdef ALARM_PUSH
+// Latched alarms, kept across commands.
+static AT_alarm_context_t at_alarm;
+#endif
 
 /*** AT local functions ***/
 
@@ -98,6 +297,49 @@ static void AT_response_add_value(int tx_value, STRING_format_t format, unsigned
 	AT_response_add_string(str_value);
 }
 
+#if (defined BULK_TRANSFER) || (defined DIAGNOSTICS)
+/* APPEND A BYTE ARRAY IN HEXADECIMAL TO THE REPONSE BUFFER.
+ * @param data:			Bytes to add.
+ * @param data_length:	Number of bytes.
+ * @return:				None.
+ */
+static void AT_response_add_bytes(unsigned char* data, unsigned int data_length) {
+	// Local variables.
+	char str_byte[3];
+	unsigned int idx = 0;
+	// Two digits per byte without prefix.
+	str_byte[2] = '\0';
+	for (idx=0 ; idx<data_length ; idx++) {
+		str_byte[0] = STRING_hexa_to_ascii((data[idx] >> 4) & 0x0F);
+		str_byte[1] = STRING_hexa_to_ascii(data[idx] & 0x0F);
+		AT_response_add_string(str_byte);
+	}
+}
+#endif
+
+/* APPEND A VALUE TO THE STATUS FRAME.
+ * @param value:		Value to add.
+ * @param format:		Printing format.
+ * @param separator:	Character to add after the value.
+ * @return:				None.
+ */
+static void AT_status_frame_add_value(int value, STRING_format_t format, char separator) {
+	// Local variables.
+	char str_value[AT_STRING_VALUE_BUFFER_LENGTH];
+	unsigned char idx = 0;
+	// Reset string.
+	for (idx=0 ; idx<AT_STRING_VALUE_BUFFER_LENGTH ; idx++) str_value[idx] = '\0';
+	// Convert value to string.
+	STRING_convert_value(value, format, (format == STRING_FORMAT_HEXADECIMAL) ? 1 : 0, str_value);
+	// Add string and separator (keep room for the CRC).
+	for (idx=0 ; (str_value[idx] != '\0') && (at_status_frame.length < (AT_STATUS_FRAME_LENGTH - 1)) ; idx++) {
+		at_status_frame.data[at_status_frame.length++] = str_value[idx];
+	}
+	if (at_status_frame.length < AT_STATUS_FRAME_LENGTH) {
+		at_status_frame.data[at_status_frame.length++] = separator;
+	}
+}
+
 /* PRINT OK THROUGH AT INTERFACE.
  * @param:	None.
  * @return:	None.
@@ -126,6 +368,193 @@ static void AT_print_error(AT_error_source_t error_source, unsigned int error_co
 	AT_response_add_string(AT_RESPONSE_END);
 }
 
+#ifdef BULK_TRANSFER
+/* FREEZE A BULK READ OBJECT SO THAT ALL ITS CHUNKS COME FROM THE SAME IMAGE.
+ * @param object:	Object identifier.
+ * @return:			1 if the object exists, 0 otherwise.
+ */
+static unsigned char AT_freeze_bulk_object(AT_bulk_object_t object) {
+	switch (object) {
+#ifdef RETAINED_DATA
+	case AT_BULK_OBJECT_NOINIT:
+		NOINIT_get_data(&at_bulk.copy.noinit);
+		at_bulk.data = (unsigned char*) &at_bulk.copy.noinit;
+		at_bulk.size = sizeof(NOINIT_data_t);
+		break;
+#endif
+#ifdef ANOMALY_DETECTION
+	case AT_BULK_OBJECT_ANOMALY:
+		ANOMALY_get_baselines(at_bulk.copy.baseline);
+		at_bulk.data = (unsigned char*) at_bulk.copy.baseline;
+		at_bulk.size = sizeof(at_bulk.copy.baseline);
+		break;
+#endif
+	case AT_BULK_OBJECT_EEPROM:
+		at_bulk.data = (unsigned char*) EEPROM_START_ADDRESS;
+		at_bulk.size = EEPROM_SIZE;
+		break;
+	default:
+		at_bulk.data = 0;
+		at_bulk.size = 0;
+		return 0;
+	}
+	at_bulk.object = object;
+	at_bulk.generation++;
+	return 1;
+}
+
+/* CHECK IF A BULK READ OBJECT IS FROZEN.
+ * @param object:	Object identifier.
+ * @return:			1 if the object was frozen by the last size command, 0 otherwise.
+ */
+static unsigned char AT_is_bulk_object_frozen(AT_bulk_object_t object) {
+	return ((at_bulk.data != 0) && (at_bulk.object == object));
+}
+#endif
+
+#ifdef DIAGNOSTICS
+/* APPEND A LITTLE ENDIAN VALUE TO A DIAGNOSTICS RECORD.
+ * @param diagnostics:	Record to fill.
+ * @param value:		Value to add.
+ * @param value_length:	Number of bytes of the value.
+ * @return:				None.
+ */
+static void AT_diagnostics_add_value(AT_diagnostics_t* diagnostics, unsigned int value, unsigned char value_length) {
+	// Local variables.
+	unsigned char idx = 0;
+	// A truncated record is never printed.
+	if (((diagnostics -> length) + value_length) > AT_DIAGNOSTICS_LENGTH_MAX_BYTES) {
+		(diagnostics -> overflow) = 1;
+		return;
+	}
+	for (idx=0 ; idx<value_length ; idx++) {
+		(diagnostics -> data)[(diagnostics -> length)++] = (unsigned char) ((value >> (8 * idx)) & 0xFF);
+	}
+}
+
+/* APPEND A TYPE-LENGTH HEADER TO A DIAGNOSTICS RECORD.
+ * @param diagnostics:	Record to fill.
+ * @param type:			Type of the following value.
+ * @param length:		Length of the following value in bytes.
+ * @return:				None.
+ */
+static void AT_diagnostics_add_header(AT_diagnostics_t* diagnostics, AT_diagnostics_type_t type, unsigned char length) {
+	AT_diagnostics_add_value(diagnostics, type, 1);
+	AT_diagnostics_add_value(diagnostics, length, 1);
+}
+
+/* PRINT ALL DIAGNOSTICS COUNTERS IN A SINGLE TLV RECORD.
+ * @param reset:	Reset counters after reading if non zero.
+ * @return:			None.
+ */
+static void AT_print_diagnostics(unsigned char reset) {
+	// Local variables.
+	AT_diagnostics_t diagnostics;
+#ifdef RETAINED_DATA
+	NOINIT_data_t noinit_data;
+	unsigned char idx = 0;
+#endif
+	// Version.
+	diagnostics.length = 0;
+	diagnostics.overflow = 0;
+	AT_diagnostics_add_value(&diagnostics, AT_DIAGNOSTICS_VERSION, 1);
+	// Records of disabled features are omitted.
+#ifdef RETAINED_DATA
+	// Reset counters (saturated to 16 bits).
+	NOINIT_get_data(&noinit_data);
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_RESET_COUNTS, (2 * NOINIT_RESET_SOURCE_LAST));
+	for (idx=0 ; idx<NOINIT_RESET_SOURCE_LAST ; idx++) {
+		AT_diagnostics_add_value(&diagnostics, (noinit_data.reset_count[idx] > 0xFFFF) ? 0xFFFF : noinit_data.reset_count[idx], 2);
+	}
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_ENERGY, 4);
+	AT_diagnostics_add_value(&diagnostics, noinit_data.energy_mj, 4);
+#endif
+#ifdef ENERGY_GOVERNOR
+	// Energy governor level and average current.
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_GOVERNOR, 5);
+	AT_diagnostics_add_value(&diagnostics, GOVERNOR_get_level(), 1);
+	AT_diagnostics_add_value(&diagnostics, GOVERNOR_get_average_current(), 4);
+#endif
+	// Error statistics.
+#ifdef ANOMALY_DETECTION
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_ANOMALY, 4);
+	AT_diagnostics_add_value(&diagnostics, ANOMALY_get_status(), 4);
+#endif
+#ifdef ALARM_PUSH
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_ALARMS, 2);
+	AT_diagnostics_add_value(&diagnostics, at_alarm.alarms, 1);
+	AT_diagnostics_add_value(&diagnostics, at_alarm.pending, 1);
+#endif
+#ifdef STORAGE_MODE
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_STANDBY_COUNT, 4);
+	AT_diagnostics_add_value(&diagnostics, STORAGE_get_standby_count(), 4);
+#endif
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_UPTIME, 4);
+	AT_diagnostics_add_value(&diagnostics, RTC_get_uptime_seconds(), 4);
+#ifdef NVM_QUEUE
+	// NVM programming errors (saturated to 16 bits).
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_NVM_ERRORS, 2);
+	AT_diagnostics_add_value(&diagnostics, (NVM_get_error_count() > 0xFFFF) ? 0xFFFF : NVM_get_error_count(), 2);
+#endif
+#ifdef ENERGY_GOVERNOR
+	// Run and sleep residency totals in ms.
+	AT_diagnostics_add_header(&diagnostics, AT_DIAGNOSTICS_TYPE_RESIDENCY, 8);
+	AT_diagnostics_add_value(&diagnostics, GOVERNOR_get_residency_ms(GOVERNOR_RESIDENCY_RUN), 4);
+	AT_diagnostics_add_value(&diagnostics, GOVERNOR_get_residency_ms(GOVERNOR_RESIDENCY_SLEEP), 4);
+#endif
+	// CRC of the whole record.
+	AT_diagnostics_add_value(&diagnostics, MATH_crc16(diagnostics.data, diagnostics.length), 2);
+	if (diagnostics.overflow != 0) {
+		AT_print_error(AT_ERROR_SOURCE_PERIPHERAL, 0);
+		return;
+	}
+	AT_response_add_bytes(diagnostics.data, diagnostics.length);
+	AT_response_add_string(AT_RESPONSE_END);
+	// Reset counters once read.
+	if (reset != 0) {
+#ifdef RETAINED_DATA
+		NOINIT_clear_reset_counts();
+#endif
+#ifdef ANOMALY_DETECTION
+		ANOMALY_clear_counters();
+#endif
+#ifdef STORAGE_MODE
+		STORAGE_clear_standby_count();
+#endif
+	}
+}
+#endif
+
+#ifdef ALARM_PUSH
+/* SEND LATCHED ALARMS WITHOUT BEING POLLED.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_push_alarm(void) {
+	// Local variables.
+	char alarm_frame[AT_ALARM_FRAME_LENGTH];
+	char str_value[AT_STRING_VALUE_BUFFER_LENGTH];
+	unsigned char length = 0;
+	unsigned char idx = 0;
+	// Build frame.
+	for (idx=0 ; AT_RESPONSE_ALARM[idx] != '\0' ; idx++) alarm_frame[length++] = AT_RESPONSE_ALARM[idx];
+	for (idx=0 ; idx<AT_STRING_VALUE_BUFFER_LENGTH ; idx++) str_value[idx] = '\0';
+	STRING_convert_value((int) LPUART1_get_node_address(), STRING_FORMAT_HEXADECIMAL, 1, str_value);
+	for (idx=0 ; str_value[idx] != '\0' ; idx++) alarm_frame[length++] = str_value[idx];
+	alarm_frame[length++] = AT_CHAR_SEPARATOR;
+	for (idx=0 ; idx<AT_STRING_VALUE_BUFFER_LENGTH ; idx++) str_value[idx] = '\0';
+	STRING_convert_value((int) at_alarm.alarms, STRING_FORMAT_HEXADECIMAL, 1, str_value);
+	for (idx=0 ; str_value[idx] != '\0' ; idx++) alarm_frame[length++] = str_value[idx];
+	alarm_frame[length++] = STRING_CHAR_LF;
+	// Retried at next call if the bus was busy or another node won the arbitration.
+	LPUART1_disable_rx();
+	if (LPUART1_send_bytes_arbitrated((unsigned char*) alarm_frame, length) != 0) {
+		at_alarm.pending = 0;
+	}
+	LPUART1_enable_rx();
+}
+#endif
+
 /* PARSE THE CURRENT AT COMMAND BUFFER.
  * @param:	None.
  * @return:	None.
@@ -135,29 +564,286 @@ static void AT_decode(void) {
 	PARSER_Status parser_status = PARSER_ERROR_UNKNOWN_COMMAND;
 	int generic_int_1 = 0;
 	int generic_int_2 = 0;
+	int generic_int_3 = 0;
 	int data_idx = 0;
 	int enable = 0;
 	unsigned int adc_data = 0;
+	unsigned char adc_status = 0;
+	unsigned char loop_idx = 0;
+#ifdef RETAINED_DATA
+	NOINIT_data_t noinit_data;
+#endif
 	unsigned char extracted_length = 0;
+	ADC_snapshot_t adc_snapshot;
+	unsigned char data_idx_snapshot = 0;
+#ifdef ADC_STREAM
+	unsigned int ripple_amplitudes[ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX];
+#endif
+#ifdef ENERGY_GOVERNOR
+	GOVERNOR_settings_t governor_settings;
+#endif
+#ifdef BOOT_PROFILE
+	BOOT_profile_t boot_profile;
+#endif
+#ifdef IRQ_STATS
+	unsigned int irq_stats_us = 0;
+	unsigned char idx = 0;
+#endif
+	// Status command AT$STS?<CR> is answered with the pre-serialized frame before any other processing.
+	at_ctx.at_parser.rx_buf_length = (at_ctx.at_command_buf_idx - 1); // To ignore line end.
+	if ((at_ctx.at_command_buf_idx >= AT_COMMAND_LENGTH_MIN) && (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_STATUS) == PARSER_SUCCESS)) {
+		LPUART1_send_bytes(at_status_frame.data, at_status_frame.length);
+		AT_init();
+		return;
+	}
 	// Empty or too short command.
 	if (at_ctx.at_command_buf_idx < AT_COMMAND_LENGTH_MIN) {
 		AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_UNKNOWN_COMMAND);
 	}
 	else {
-		// Update parser length.
-		at_ctx.at_parser.rx_buf_length = (at_ctx.at_command_buf_idx - 1); // To ignore line end.
 		// Test command AT<CR>.
 		if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_TEST) == PARSER_SUCCESS) {
 			AT_print_ok();
 		}
-		// ADC command AT$ADC?<CR>.
+		// ADC snapshot command AT$ADC?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_ADC_SNAPSHOT) == PARSER_SUCCESS) {
+			// Read last background acquisition.
+			ADC1_get_snapshot(&adc_snapshot);
+			// Print all data followed by timestamp.
+			for (data_idx_snapshot=0 ; data_idx_snapshot<ADC_DATA_IDX_MAX ; data_idx_snapshot++) {
+				AT_response_add_value((int) adc_snapshot.data[data_idx_snapshot], STRING_FORMAT_DECIMAL, 0);
+				AT_response_add_string(",");
+			}
+			AT_response_add_value((int) adc_snapshot.timestamp_seconds, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+#ifdef ANOMALY_DETECTION
+		// Anomaly status command AT$ANO?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_ANOMALY_STATUS) == PARSER_SUCCESS) {
+			AT_response_add_value((int) ANOMALY_get_status(), STRING_FORMAT_HEXADECIMAL, 1);
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+		// Anomaly counters reset command AT$ANC<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_ANOMALY_CLEAR) == PARSER_SUCCESS) {
+			ANOMALY_clear_counters();
+			AT_update_status_frame();
+			AT_print_ok();
+		}
+		// Anomaly threshold command AT$ANO=<sigma_threshold><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_ANOMALY) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			if ((generic_int_1 <= 0) || (generic_int_1 > ANOMALY_SIGMA_THRESHOLD_MAX)) {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_OVERFLOW);
+			}
+			else {
+				ANOMALY_set_sigma_threshold(generic_int_1);
+				AT_print_ok();
+			}
+		}
+#endif
+#ifdef RETAINED_DATA
+		// Retained data command AT$NOI?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_NOINIT) == PARSER_SUCCESS) {
+			NOINIT_get_data(&noinit_data);
+			// Print reset counters followed by output energy.
+			for (loop_idx=0 ; loop_idx<NOINIT_RESET_SOURCE_LAST ; loop_idx++) {
+				AT_response_add_value((int) noinit_data.reset_count[loop_idx], STRING_FORMAT_DECIMAL, 0);
+				AT_response_add_string(",");
+			}
+			AT_response_add_value((int) noinit_data.energy_mj, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+#endif
+#ifdef ENERGY_GOVERNOR
+		// Energy governor status command AT$GOV?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_GOVERNOR) == PARSER_SUCCESS) {
+			GOVERNOR_get_settings(&governor_settings);
+			// Print target, level, estimated current and effective settings.
+			AT_response_add_value((int) GOVERNOR_get_target(), STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) GOVERNOR_get_level(), STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) GOVERNOR_get_average_current(), STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) governor_settings.measurement_period_seconds, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) governor_settings.led_period_seconds, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+		// Energy governor target command AT$GOV=<target_ua><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_GOVERNOR) == PARSER_SUCCESS) {
+			// Target can be given with unit (ex: 1.5mA).
+			parser_status = PARSER_get_fixed_point_parameter(&at_ctx.at_parser, AT_CHAR_SEPARATOR, 1, AT_UNIT_CURRENT, AT_UNIT_POWER_UA, 0, AT_PARAMETER_MAX, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			GOVERNOR_set_target(generic_int_1);
+			AT_print_ok();
+		}
+#endif
+#ifdef BULK_TRANSFER
+		// Transfer status command AT$XFR?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_TRANSFER) == PARSER_SUCCESS) {
+			AT_response_add_value((int) at_transfer.state, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) at_transfer.offset, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) at_transfer.length, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+		// Transfer control command AT$XFR=<action><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_TRANSFER) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			switch (generic_int_1) {
+			case AT_TRANSFER_ACTION_ABORT:
+				at_transfer.state = AT_TRANSFER_STATE_IDLE;
+				AT_print_ok();
+				break;
+			case AT_TRANSFER_ACTION_PAUSE:
+			case AT_TRANSFER_ACTION_RESUME:
+				// Pause and resume only apply to an unfinished transfer.
+				if (at_transfer.state == AT_TRANSFER_STATE_IDLE) {
+					AT_print_error(AT_ERROR_SOURCE_PERIPHERAL, 0);
+				}
+				else {
+					at_transfer.state = (generic_int_1 == AT_TRANSFER_ACTION_PAUSE) ? AT_TRANSFER_STATE_PAUSED : AT_TRANSFER_STATE_RUNNING;
+					AT_print_ok();
+				}
+				break;
+			default:
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_INVALID);
+				break;
+			}
+		}
+#endif
+#ifdef ALARM_PUSH
+		// Alarm status command AT$ALM?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_ALARM) == PARSER_SUCCESS) {
+			AT_response_add_value((int) at_alarm.enable, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) at_alarm.alarms, STRING_FORMAT_HEXADECIMAL, 1);
+			AT_response_add_string(",");
+			AT_response_add_value((int) at_alarm.pending, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+		// Alarm push command AT$ALM=<enable><CR> (also acknowledges latched alarms).
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_ALARM) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_BOOLEAN, AT_CHAR_SEPARATOR, 1, &enable);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			AT_set_alarm_push(enable);
+			AT_print_ok();
+		}
+#endif
+#ifdef BOOT_PROFILE
+		// Boot profile command AT$BOT?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_BOOT) == PARSER_SUCCESS) {
+			BOOT_get_profile(&boot_profile);
+			// Print RTC clock source, storage wake-up flag and duration of each phase in us.
+			AT_response_add_value((int) boot_profile.rtc_clock_source, STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) boot_profile.storage_resume, STRING_FORMAT_DECIMAL, 0);
+			for (loop_idx=0 ; loop_idx<BOOT_PHASE_LAST ; loop_idx++) {
+				AT_response_add_string(",");
+				AT_response_add_value((int) boot_profile.phase_duration_us[loop_idx], STRING_FORMAT_DECIMAL, 0);
+			}
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+#endif
+#ifdef STORAGE_MODE
+		// Storage mode status command AT$STO?<CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_COMMAND, AT_COMMAND_STORAGE) == PARSER_SUCCESS) {
+			AT_response_add_value((int) STORAGE_get_enable(), STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(",");
+			AT_response_add_value((int) STORAGE_get_standby_count(), STRING_FORMAT_DECIMAL, 0);
+			AT_response_add_string(AT_RESPONSE_END);
+		}
+		// Storage mode command AT$STO=<enable><CR>.
+		// Settings, counters and calibration are kept in backup registers, anomaly baselines are learned again after each wake-up.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_STORAGE) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_BOOLEAN, AT_CHAR_SEPARATOR, 1, &enable);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			STORAGE_set_enable(enable);
+			AT_print_ok();
+		}
+#endif
+#ifdef DIAGNOSTICS
+		// Diagnostics command AT$DIA=<reset><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_DIAGNOSTICS) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_BOOLEAN, AT_CHAR_SEPARATOR, 1, &enable);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			AT_print_diagnostics(enable);
+		}
+#endif
+#ifdef BULK_TRANSFER
+		// Bulk object size command AT$BLS=<object><CR> (freezes the object for AT$BLK and AT$BLT).
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_BULK_SIZE) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			if (AT_freeze_bulk_object(generic_int_1) == 0) {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_INVALID);
+			}
+			else {
+				// Print size, CRC of the whole object to check reassembly and snapshot generation.
+				AT_response_add_value((int) at_bulk.size, STRING_FORMAT_DECIMAL, 0);
+				AT_response_add_string(",");
+				AT_response_add_value((int) MATH_crc16(at_bulk.data, at_bulk.size), STRING_FORMAT_HEXADECIMAL, 1);
+				AT_response_add_string(",");
+				AT_response_add_value((int) at_bulk.generation, STRING_FORMAT_DECIMAL, 0);
+				AT_response_add_string(AT_RESPONSE_END);
+			}
+		}
+		// Bulk read command AT$BLK=<object>,<offset>,<length><CR> (object must be frozen by AT$BLS).
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_BULK_READ) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 0, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 0, &generic_int_2);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_3);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			if ((AT_is_bulk_object_frozen(generic_int_1) == 0) || (generic_int_2 < 0) || (generic_int_2 >= (int) at_bulk.size) || (generic_int_3 <= 0)) {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_INVALID);
+			}
+			else {
+				// Clamp length to object end and response capacity.
+				if (generic_int_3 > AT_BULK_LENGTH_MAX_BYTES) {
+					generic_int_3 = AT_BULK_LENGTH_MAX_BYTES;
+				}
+				if ((generic_int_2 + generic_int_3) > (int) at_bulk.size) {
+					generic_int_3 = at_bulk.size - generic_int_2;
+				}
+				// Print snapshot generation, offset, data and chunk CRC.
+				AT_response_add_value((int) at_bulk.generation, STRING_FORMAT_DECIMAL, 0);
+				AT_response_add_string(",");
+				AT_response_add_value(generic_int_2, STRING_FORMAT_DECIMAL, 0);
+				AT_response_add_string(",");
+				AT_response_add_bytes(&(at_bulk.data[generic_int_2]), generic_int_3);
+				AT_response_add_string(",");
+				AT_response_add_value((int) MATH_crc16(&(at_bulk.data[generic_int_2]), generic_int_3), STRING_FORMAT_HEXADECIMAL, 1);
+				AT_response_add_string(AT_RESPONSE_END);
+			}
+		}
+		// Bulk transfer command AT$BLT=<object><CR> (object must be frozen by AT$BLS).
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_BULK_TRANSFER) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			if (AT_is_bulk_object_frozen(generic_int_1) == 0) {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_INVALID);
+			}
+			else {
+				// Whole object is sent after the response, one hexadecimal line per chunk (size and CRC are given by AT$BLS).
+				AT_start_transfer(at_bulk.data, at_bulk.size);
+				AT_print_ok();
+			}
+		}
+#endif
+		// ADC command AT$ADC=<data_idx><CR>.
 		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_ADC) == PARSER_SUCCESS) {
 			// Read index parameter.
 			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &data_idx);
 			if (parser_status == PARSER_SUCCESS) {
 				// Perform measurements.
 				ADC1_enable();
-				ADC1_perform_measurements();
+				ADC1_perform_measurements(ADC_DATA_MASK_ALL);
 				ADC1_disable();
 				// Get result.
 				ADC1_get_data(data_idx, &adc_data);
@@ -169,30 +855,190 @@ static void AT_decode(void) {
 				AT_print_error(AT_ERROR_SOURCE_PARSER, parser_status);
 			}
 		}
+#ifdef ADC_STREAM
+		// Decimated ADC command AT$CIC=<data_idx>,<order>,<ratio_log2><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_CIC) == PARSER_SUCCESS) {
+			// Read data index, filter order and decimation ratio.
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 0, &data_idx);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 0, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_2);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			// Check parameters (burst length must stay well below the IWDG period).
+			if ((generic_int_1 < 1) || (generic_int_1 > CIC_ORDER_MAX) || (generic_int_2 < 0) || (generic_int_2 > CIC_RATIO_LOG2_MAX) || ((generic_int_1 << generic_int_2) > ADC_STREAM_LENGTH_MAX_SAMPLES)) {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_OVERFLOW);
+			}
+			else {
+				// Perform measurement (TIM2 is used as conversion trigger).
+				LED_stop();
+				ADC1_enable();
+				adc_status = ADC1_perform_decimated_measurement(data_idx, generic_int_1, generic_int_2, &adc_data);
+				ADC1_disable();
+				// Print response.
+				if (adc_status != 0) {
+					AT_response_add_value((int) adc_data, STRING_FORMAT_DECIMAL, 0);
+					AT_response_add_string(AT_RESPONSE_END);
+				}
+				else {
+					AT_print_error(AT_ERROR_SOURCE_PERIPHERAL, 0);
+				}
+			}
+		}
+		// Ripple frequency command AT$RPF=<slot>,<frequency_hz><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_RIPPLE_FREQUENCY) == PARSER_SUCCESS) {
+			// Read slot and frequency.
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 0, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			// Detectors only see frequencies below Nyquist.
+			parser_status = PARSER_get_fixed_point_parameter(&at_ctx.at_parser, AT_CHAR_SEPARATOR, 1, AT_UNIT_FREQUENCY, 0, 0, ((ADC_STREAM_SAMPLING_FREQUENCY_HZ / 2) - 1), &generic_int_2);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			// Check slot.
+			if ((generic_int_1 < 0) || (generic_int_1 >= ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX)) {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_OVERFLOW);
+			}
+			else {
+				at_ripple_frequencies_hz[generic_int_1] = generic_int_2;
+				AT_print_ok();
+			}
+		}
+		// Ripple analysis command AT$RPL=<data_idx><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_RIPPLE) == PARSER_SUCCESS) {
+			// Read index parameter.
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &data_idx);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			// Perform analysis (TIM2 is used as conversion trigger).
+			LED_stop();
+			ADC1_enable();
+			adc_status = ADC1_perform_ripple_analysis(data_idx, at_ripple_frequencies_hz, ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX, ripple_amplitudes);
+			ADC1_disable();
+			// Print amplitude of each frequency.
+			if (adc_status != 0) {
+				for (loop_idx=0 ; loop_idx<ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX ; loop_idx++) {
+					AT_response_add_value((int) at_ripple_frequencies_hz[loop_idx], STRING_FORMAT_DECIMAL, 0);
+					AT_response_add_string("Hz=");
+					AT_response_add_value((int) ripple_amplitudes[loop_idx], STRING_FORMAT_DECIMAL, 0);
+					AT_response_add_string((loop_idx < (ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX - 1)) ? "," : AT_RESPONSE_END);
+				}
+			}
+			else {
+				AT_print_error(AT_ERROR_SOURCE_PERIPHERAL, 0);
+			}
+		}
+#endif
+		// Load LED cadence command AT$LED=<period_seconds><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_LED) == PARSER_SUCCESS) {
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_1);
+			if (parser_status != PARSER_SUCCESS) goto errors;
+			if ((generic_int_1 < 0) || (generic_int_1 > LED_LOAD_PERIOD_MAX_SECONDS)) {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_PARAMETER_DEC_INVALID);
+			}
+			else {
+				LED_set_load_period(generic_int_1);
+				AT_print_ok();
+			}
+		}
 		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_OUT) == PARSER_SUCCESS) {
 			// Read index parameter.
 			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_BOOLEAN, AT_CHAR_SEPARATOR, 1, &enable);
 			if (parser_status == PARSER_SUCCESS) {
 				// Set relay state.
 				RELAY_set_state(enable);
+				AT_update_status_frame();
 				AT_print_ok();
 			}
 			else {
 				AT_print_error(AT_ERROR_SOURCE_PARSER, parser_status);
 			}
 		}
+#ifdef IRQ_STATS
+		// Interrupt statistics command AT$IRQ=<source><CR>.
+		else if (PARSER_compare(&at_ctx.at_parser, PARSER_MODE_HEADER, AT_HEADER_IRQ) == PARSER_SUCCESS) {
+			// Read source parameter.
+			parser_status = PARSER_get_parameter(&at_ctx.at_parser, PARSER_PARAMETER_TYPE_DECIMAL, AT_CHAR_SEPARATOR, 1, &generic_int_1);
+			if (parser_status == PARSER_SUCCESS) {
+				// Print latency, duration and masked time in us.
+				for (idx=0 ; idx<NVIC_STATS_LAST ; idx++) {
+					NVIC_get_stats(generic_int_1, idx, &irq_stats_us);
+					AT_response_add_value((int) irq_stats_us, STRING_FORMAT_DECIMAL, 0);
+					AT_response_add_string((idx < (NVIC_STATS_LAST - 1)) ? "," : AT_RESPONSE_END);
+				}
+			}
+			else {
+				AT_print_error(AT_ERROR_SOURCE_PARSER, parser_status);
+			}
+		}
+#endif
 		// Unknown command.
 		else {
 			AT_print_error(AT_ERROR_SOURCE_PARSER, PARSER_ERROR_UNKNOWN_COMMAND);
 		}
 
 	}
+	goto end;
+errors:
+	AT_print_error(AT_ERROR_SOURCE_PARSER, parser_status);
+end:
 	// Send response.
 	LPUART1_send_string(at_ctx.at_response_buf);
 	// Reset AT parser.
 	AT_init();
 }
 
+#ifdef BULK_TRANSFER
+/* SEND PENDING TRANSFER CHUNK BY CHUNK, LISTENING FOR COMMANDS BETWEEN CHUNKS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_run_transfer(void) {
+	// Local variables.
+	char chunk[(2 * AT_TRANSFER_CHUNK_LENGTH_BYTES) + 1];
+	unsigned int chunk_length = 0;
+	unsigned int idx = 0;
+	unsigned char gap_count = 0;
+	// Stop on completion, abort or pause (which can only be received during a gap).
+	while (at_transfer.state == AT_TRANSFER_STATE_RUNNING) {
+		IWDG_reload();
+		// Send next chunk.
+		chunk_length = at_transfer.length - at_transfer.offset;
+		if (chunk_length > AT_TRANSFER_CHUNK_LENGTH_BYTES) {
+			chunk_length = AT_TRANSFER_CHUNK_LENGTH_BYTES;
+		}
+		// Bytes are sent in hexadecimal since bytes with MSB set are address marks on the bus.
+		for (idx=0 ; idx<chunk_length ; idx++) {
+			chunk[2 * idx] = STRING_hexa_to_ascii((at_transfer.data[at_transfer.offset + idx] >> 4) & 0x0F);
+			chunk[(2 * idx) + 1] = STRING_hexa_to_ascii(at_transfer.data[at_transfer.offset + idx] & 0x0F);
+		}
+		chunk[2 * chunk_length] = STRING_CHAR_LF;
+		LPUART1_disable_rx();
+		LPUART1_send_bytes((unsigned char*) chunk, ((2 * chunk_length) + 1));
+		LPUART1_enable_rx();
+		at_transfer.offset += chunk_length;
+		if (at_transfer.offset >= at_transfer.length) {
+			at_transfer.state = AT_TRANSFER_STATE_IDLE;
+			break;
+		}
+		// Bus idle gap.
+		LPTIM1_delay_milliseconds(AT_TRANSFER_GAP_MS);
+		// Wait for the end of a command started during the gap.
+		gap_count = 0;
+		while ((at_ctx.at_command_buf_idx != 0) && (at_ctx.at_line_end_flag == 0) && (gap_count < AT_TRANSFER_COMMAND_GAPS_MAX)) {
+			LPTIM1_delay_milliseconds(AT_TRANSFER_GAP_MS);
+			gap_count++;
+		}
+		if (at_ctx.at_line_end_flag != 0) {
+			LPUART1_disable_rx();
+			AT_decode();
+			LED_notify_activity();
+		}
+		else if (at_ctx.at_command_buf_idx != 0) {
+			// Drop incomplete command.
+			AT_init();
+		}
+	}
+}
+#endif
+
 /*** AT functions ***/
 
 /* INIT AT MANAGER.
@@ -224,10 +1070,31 @@ void AT_task(void) {
 	// Trigger decoding function if line end found.
 	if (at_ctx.at_line_end_flag != 0) {
 		LPUART1_disable_rx();
-		LED_single_blink(100, TIM2_CHANNEL_MASK_BLUE);
 		AT_decode();
 		LPUART1_enable_rx();
+		// Activity indication is handled by the LED task.
+		LED_notify_activity();
 	}
+#ifdef BULK_TRANSFER
+	// Send pending transfer.
+	if (at_transfer.state == AT_TRANSFER_STATE_RUNNING) {
+		AT_run_transfer();
+	}
+#endif
+#ifdef ALARM_PUSH
+	// Push alarms when enabled and no command is being received.
+	if ((at_alarm.enable != 0) && (at_alarm.pending != 0) && (at_ctx.at_command_buf_idx == 0)) {
+		AT_push_alarm();
+	}
+#endif
+}
+
+/* CHECK IF A COMPLETE COMMAND IS WAITING FOR DECODING.
+ * @param:	None.
+ * @return:	1 if a command line end was received, 0 otherwise.
+ */
+unsigned char AT_is_command_pending(void) {
+	return (at_ctx.at_line_end_flag != 0);
 }
 
 /* FILL AT COMMAND BUFFER WITH A NEW BYTE (CALLED BY USART INTERRUPT).
@@ -250,3 +1117,90 @@ void AT_fill_rx_buffer(unsigned char rx_byte) {
 		at_ctx.at_line_end_flag = 1;
 	}
 }
+
+#ifdef BULK_TRANSFER
+/* START A CHUNKED TRANSFER WHICH CAN BE PREEMPTED BY COMMANDS.
+ * @param data:		Bytes to send (must remain valid until the transfer ends).
+ * @param length:	Number of bytes to send.
+ * @return:			None.
+ */
+void AT_start_transfer(unsigned char* data, unsigned int length) {
+	// Replace any previous transfer.
+	at_transfer.data = data;
+	at_transfer.length = length;
+	at_transfer.offset = 0;
+	at_transfer.state = (length != 0) ? AT_TRANSFER_STATE_RUNNING : AT_TRANSFER_STATE_IDLE;
+}
+#endif
+
+/* REBUILD STATUS FRAME FROM LATEST MEASUREMENTS AND STATES.
+ * @param:	None.
+ * @return:	None.
+ * The frame is only rebuilt if a new acquisition was performed or if a state changed.
+ */
+void AT_update_status_frame(void) {
+	// Local variables.
+	unsigned int adc_sequence = ADC1_get_sequence();
+	unsigned char relay_state = RELAY_get_state();
+	unsigned int anomaly_status = 0;
+	unsigned int iout_offset_ua = 0;
+	unsigned int adc_data = 0;
+	unsigned char data_idx = 0;
+#ifdef ANOMALY_DETECTION
+	anomaly_status = ANOMALY_get_status();
+	iout_offset_ua = ANOMALY_get_iout_offset();
+#endif
+	// Check if frame is up to date.
+	if ((at_status_frame.valid != 0) && (adc_sequence == at_status_frame.adc_sequence) && (relay_state == at_status_frame.relay_state) && (anomaly_status == at_status_frame.anomaly_status)) return;
+	at_status_frame.adc_sequence = adc_sequence;
+	at_status_frame.relay_state = relay_state;
+	at_status_frame.anomaly_status = anomaly_status;
+	at_status_frame.valid = 1;
+	// Measurements (data already converted by the periodic task are not converted again).
+	at_status_frame.length = 0;
+	for (data_idx=0 ; data_idx<ADC_DATA_IDX_ACQUIRED_MAX ; data_idx++) {
+		ADC1_get_data(data_idx, &adc_data);
+		// Remove learned current sensor offset.
+		if (data_idx == ADC_DATA_IDX_IOUT_UA) {
+			adc_data = (adc_data > iout_offset_ua) ? (adc_data - iout_offset_ua) : 0;
+		}
+		AT_status_frame_add_value((int) adc_data, STRING_FORMAT_DECIMAL, AT_CHAR_SEPARATOR);
+	}
+	// States and alarms.
+	AT_status_frame_add_value((int) relay_state, STRING_FORMAT_DECIMAL, AT_CHAR_SEPARATOR);
+	AT_status_frame_add_value((int) anomaly_status, STRING_FORMAT_HEXADECIMAL, AT_CHAR_SEPARATOR);
+	AT_status_frame_add_value((int) ADC1_get_timestamp_seconds(), STRING_FORMAT_DECIMAL, AT_CHAR_SEPARATOR);
+	// CRC of all previous characters.
+	AT_status_frame_add_value((int) MATH_crc16(at_status_frame.data, at_status_frame.length), STRING_FORMAT_HEXADECIMAL, STRING_CHAR_LF);
+}
+
+#ifdef ALARM_PUSH
+/* LATCH AN ALARM UNTIL IT IS ACKNOWLEDGED BY THE MASTER.
+ * @param alarm:	Alarm to latch.
+ * @return:			None.
+ */
+void AT_latch_alarm(AT_alarm_t alarm) {
+	// Only push new alarms.
+	if ((alarm >= AT_ALARM_LAST) || ((at_alarm.alarms & (0b1 << alarm)) != 0)) return;
+	at_alarm.alarms |= (0b1 << alarm);
+	at_alarm.pending = 1;
+}
+
+/* ENABLE OR DISABLE ALARM PUSH (ALSO ACKNOWLEDGES LATCHED ALARMS).
+ * @param enable:	Push latched alarms without being polled if non zero.
+ * @return:			None.
+ */
+void AT_set_alarm_push(unsigned char enable) {
+	at_alarm.enable = (enable != 0) ? 1 : 0;
+	at_alarm.alarms = 0;
+	at_alarm.pending = 0;
+}
+
+/* GET ALARM PUSH SETTING.
+ * @param:	None.
+ * @return:	1 if alarm push is enabled, 0 otherwise.
+ */
+unsigned char AT_get_alarm_push(void) {
+	return at_alarm.enable;
+}
+#endif
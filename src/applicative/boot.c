@@ -0,0 +1,81 @@
+/*
+ * boot.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "boot.h"
+
+#include "mode.h"
+#include "rtc.h"
+#include "systick.h"
+
+#ifdef BOOT_PROFILE
+/*** BOOT local structures ***/
+
+typedef struct {
+	BOOT_profile_t profile;
+	unsigned int phase_start_us;
+} BOOT_context_t;
+
+/*** BOOT local global variables ***/
+
+static BOOT_context_t boot_ctx;
+
+/*** BOOT functions ***/
+
+/* INIT BOOT PROFILE (SYSTICK MUST BE STARTED).
+ * @param:	None.
+ * @return:	None.
+ */
+void BOOT_init(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Skipped phases keep a null duration.
+	for (idx=0 ; idx<BOOT_PHASE_LAST ; idx++) {
+		boot_ctx.profile.phase_duration_us[idx] = 0;
+	}
+	boot_ctx.profile.rtc_clock_source = RTC_CLOCK_SOURCE_NONE;
+	boot_ctx.profile.storage_resume = 0;
+	// First phase starts at SysTick init.
+	boot_ctx.phase_start_us = 0;
+}
+
+/* RECORD THE DURATION OF AN INIT PHASE.
+ * @param phase:	Phase which just ended (started at the end of the previous one).
+ * @return:			None.
+ */
+void BOOT_end_phase(BOOT_phase_t phase) {
+	// Local variables.
+	unsigned int time_us = SYSTICK_get_time_us();
+	if (phase < BOOT_PHASE_LAST) {
+		boot_ctx.profile.phase_duration_us[phase] = (time_us - boot_ctx.phase_start_us);
+	}
+	boot_ctx.phase_start_us = time_us;
+}
+
+/* RECORD THE CLOCK SOURCE SELECTED BY RTC INIT.
+ * @param rtc_clock_source:	RTC clock source.
+ * @return:					None.
+ */
+void BOOT_set_rtc_clock_source(RTC_clock_source_t rtc_clock_source) {
+	boot_ctx.profile.rtc_clock_source = rtc_clock_source;
+}
+
+/* RECORD IF THE BOOT WAS A WAKE-UP FROM STORAGE MODE.
+ * @param storage_resume:	Non zero on storage wake-up.
+ * @return:					None.
+ */
+void BOOT_set_storage_resume(unsigned char storage_resume) {
+	boot_ctx.profile.storage_resume = storage_resume;
+}
+
+/* GET BOOT PROFILE.
+ * @param profile:	Pointer that will contain the boot profile.
+ * @return:			None.
+ */
+void BOOT_get_profile(BOOT_profile_t* profile) {
+	(*profile) = boot_ctx.profile;
+}
+#endif
@@ -0,0 +1,191 @@
+/*
+ * governor.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "governor.h"
+
+#include "led.h"
+#include "mode.h"
+#include "rtc.h"
+
+#ifdef ENERGY_GOVERNOR
+/*** GOVERNOR local macros ***/
+
+#define GOVERNOR_WINDOW_SECONDS				300
+#define GOVERNOR_NUMBER_OF_LEVELS			4
+#define GOVERNOR_HYSTERESIS_PERCENT			75 // Relax settings only below 75% of the target.
+// Current model of each state.
+#define GOVERNOR_RUN_CURRENT_UA				250 // MCU running on MSI 2.1MHz.
+#define GOVERNOR_SLEEP_CURRENT_UA			3000 // MCU in sleep mode and LED blinking.
+#define GOVERNOR_STOP_CURRENT_UA			2 // MCU in stop mode with RTC and LPUART.
+#define GOVERNOR_RECEIVER_CURRENT_UA		300 // RS485 transceiver receiver.
+
+/*** GOVERNOR local structures ***/
+
+typedef struct {
+	unsigned int target_ua;
+	unsigned char level;
+	unsigned int window_start_seconds;
+	unsigned int residency_us[GOVERNOR_RESIDENCY_LAST];
+	unsigned int residency_total_ms[GOVERNOR_RESIDENCY_LAST]; // Previous windows.
+	unsigned int average_ua;
+} GOVERNOR_context_t;
+
+/*** GOVERNOR local global variables ***/
+
+// Settings of each throttling level, from nominal to most restrictive.
+// Receiver is never throttled so that the node can always be controlled.
+static const GOVERNOR_settings_t GOVERNOR_LEVEL_SETTINGS[GOVERNOR_NUMBER_OF_LEVELS] = {
+	{RTC_WAKEUP_PERIOD_SECONDS, LED_LOAD_PERIOD_DEFAULT_SECONDS},
+	{10, 30},
+	{30, 0},
+	{60, 0}
+};
+static GOVERNOR_context_t governor_ctx;
+
+/*** GOVERNOR local functions ***/
+
+/* COMPUTE AVERAGE CURRENT OF THE CURRENT WINDOW.
+ * @param window_seconds:	Window duration.
+ * @return:					Average current in uA.
+ */
+static unsigned int GOVERNOR_compute_average_current(unsigned int window_seconds) {
+	// Local variables.
+	unsigned long long window_us = ((unsigned long long) window_seconds) * 1000000;
+	unsigned long long awake_us = governor_ctx.residency_us[GOVERNOR_RESIDENCY_RUN] + governor_ctx.residency_us[GOVERNOR_RESIDENCY_SLEEP];
+	unsigned long long charge = 0; // In uA.us.
+	if (window_us == 0) return 0;
+	// Stop mode residency is the remaining time.
+	if (awake_us > window_us) {
+		awake_us = window_us;
+	}
+	charge += ((unsigned long long) governor_ctx.residency_us[GOVERNOR_RESIDENCY_RUN]) * GOVERNOR_RUN_CURRENT_UA;
+	charge += ((unsigned long long) governor_ctx.residency_us[GOVERNOR_RESIDENCY_SLEEP]) * GOVERNOR_SLEEP_CURRENT_UA;
+	charge += (window_us - awake_us) * GOVERNOR_STOP_CURRENT_UA;
+	// Receiver is always enabled.
+	charge += (window_us * GOVERNOR_RECEIVER_CURRENT_UA);
+	return (unsigned int) (charge / window_us);
+}
+
+/* RESET RESIDENCY COUNTERS.
+ * @param uptime_seconds:	Start of the new window.
+ * @return:					None.
+ */
+static void GOVERNOR_start_window(unsigned int uptime_seconds) {
+	// Local variables.
+	unsigned char idx = 0;
+	for (idx=0 ; idx<GOVERNOR_RESIDENCY_LAST ; idx++) {
+		governor_ctx.residency_total_ms[idx] += (governor_ctx.residency_us[idx] / 1000);
+		governor_ctx.residency_us[idx] = 0;
+	}
+	governor_ctx.window_start_seconds = uptime_seconds;
+}
+
+/*** GOVERNOR functions ***/
+
+/* INIT ENERGY GOVERNOR.
+ * @param uptime_seconds:	Current RTC uptime.
+ * @return:					None.
+ */
+void GOVERNOR_init(unsigned int uptime_seconds) {
+	// Local variables.
+	unsigned char idx = 0;
+	governor_ctx.target_ua = 0;
+	governor_ctx.level = 0;
+	governor_ctx.average_ua = 0;
+	for (idx=0 ; idx<GOVERNOR_RESIDENCY_LAST ; idx++) {
+		governor_ctx.residency_us[idx] = 0;
+		governor_ctx.residency_total_ms[idx] = 0;
+	}
+	GOVERNOR_start_window(uptime_seconds);
+}
+
+/* SET AVERAGE CURRENT BUDGET.
+ * @param target_ua:	Target average current in uA (0 to disable the governor).
+ * @return:				None.
+ */
+void GOVERNOR_set_target(unsigned int target_ua) {
+	governor_ctx.target_ua = target_ua;
+	// Go back to nominal settings when disabled.
+	if (target_ua == 0) {
+		governor_ctx.level = 0;
+	}
+}
+
+/* GET AVERAGE CURRENT BUDGET.
+ * @param:	None.
+ * @return:	Target average current in uA (0 if disabled).
+ */
+unsigned int GOVERNOR_get_target(void) {
+	return governor_ctx.target_ua;
+}
+
+/* ACCOUNT TIME SPENT IN A STATE.
+ * @param residency:	State.
+ * @param duration_us:	Time spent in the state in us.
+ * @return:				None.
+ */
+void GOVERNOR_add_residency(GOVERNOR_residency_t residency, unsigned int duration_us) {
+	if (residency < GOVERNOR_RESIDENCY_LAST) {
+		governor_ctx.residency_us[residency] += duration_us;
+	}
+}
+
+/* GET TOTAL TIME SPENT IN A STATE SINCE INIT.
+ * @param residency:	State.
+ * @return:				Total residency in ms.
+ */
+unsigned int GOVERNOR_get_residency_ms(GOVERNOR_residency_t residency) {
+	if (residency >= GOVERNOR_RESIDENCY_LAST) return 0;
+	return (governor_ctx.residency_total_ms[residency] + (governor_ctx.residency_us[residency] / 1000));
+}
+
+/* UPDATE THROTTLING LEVEL AT THE END OF EACH WINDOW.
+ * @param uptime_seconds:	Current RTC uptime.
+ * @return:					None.
+ */
+void GOVERNOR_task(unsigned int uptime_seconds) {
+	// Local variables.
+	unsigned int window_seconds = (uptime_seconds - governor_ctx.window_start_seconds);
+	// Wait for end of window.
+	if (window_seconds < GOVERNOR_WINDOW_SECONDS) return;
+	governor_ctx.average_ua = GOVERNOR_compute_average_current(window_seconds);
+	// Adjust level.
+	if (governor_ctx.target_ua != 0) {
+		if ((governor_ctx.average_ua > governor_ctx.target_ua) && (governor_ctx.level < (GOVERNOR_NUMBER_OF_LEVELS - 1))) {
+			governor_ctx.level++;
+		}
+		else if (((governor_ctx.average_ua * 100) < (governor_ctx.target_ua * GOVERNOR_HYSTERESIS_PERCENT)) && (governor_ctx.level > 0)) {
+			governor_ctx.level--;
+		}
+	}
+	GOVERNOR_start_window(uptime_seconds);
+}
+
+/* GET SETTINGS TO APPLY.
+ * @param settings:	Pointer that will contain the settings of the current level.
+ * @return:			None.
+ */
+void GOVERNOR_get_settings(GOVERNOR_settings_t* settings) {
+	(*settings) = GOVERNOR_LEVEL_SETTINGS[governor_ctx.level];
+}
+
+/* GET CURRENT THROTTLING LEVEL.
+ * @param:	None.
+ * @return:	Level (0 is nominal).
+ */
+unsigned char GOVERNOR_get_level(void) {
+	return governor_ctx.level;
+}
+
+/* GET AVERAGE CURRENT OF THE LAST WINDOW.
+ * @param:	None.
+ * @return:	Estimated average current in uA.
+ */
+unsigned int GOVERNOR_get_average_current(void) {
+	return governor_ctx.average_ua;
+}
+#endif
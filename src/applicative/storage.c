@@ -0,0 +1,210 @@
+/*
+ * storage.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "storage.h"
+
+#include "anomaly.h"
+#include "at.h"
+#include "governor.h"
+#include "led.h"
+#include "mode.h"
+#include "noinit.h"
+#include "pwr.h"
+#include "rcc.h"
+#include "rtc.h"
+
+#ifdef STORAGE_MODE
+/*** STORAGE local macros ***/
+
+#define STORAGE_MAGIC				0x53000000 // "S".
+#define STORAGE_MAGIC_MASK			0xFF000000
+#define STORAGE_FLAG_ENABLE			(0b1 << 16)
+#define STORAGE_FLAG_ALARM_PUSH		(0b1 << 17)
+#define STORAGE_SIGMA_SHIFT			12
+#define STORAGE_SIGMA_MASK			0x0000F000
+#define STORAGE_LED_PERIOD_MASK		0x00000FFF
+#define STORAGE_TARGET_SHIFT		8
+#define STORAGE_TARGET_MAX			0x00FFFFFF
+#define STORAGE_MSI_TRIM_MASK		0x000000FF
+#define STORAGE_COUNT_16_MAX		0x0000FFFF
+#define STORAGE_COUNT_8_MAX			0x000000FF
+#define STORAGE_OFFSET_MIN			-32768
+#define STORAGE_OFFSET_MAX			32767
+
+/*** STORAGE local structures ***/
+
+// Context saved in RTC backup registers (RAM is lost in standby mode).
+// HEADER:		magic (31:24) | alarm push (17) | storage enable (16) | sigma threshold (15:12) | LED period (11:0).
+// ENERGY_MJ:	output energy in mJ.
+// SETTINGS:	governor target in uA (31:8, saturated) | MSI trim (7:0).
+// COUNTERS:	standby wake-ups (31:16, saturated) | current sensor offset in uA (15:0, signed and saturated).
+// RESETS:		one saturated byte per warm reset source.
+// Anomaly baselines do not fit and are learned again after each wake-up.
+typedef enum {
+	STORAGE_BACKUP_IDX_HEADER = 0,
+	STORAGE_BACKUP_IDX_ENERGY_MJ,
+	STORAGE_BACKUP_IDX_SETTINGS,
+	STORAGE_BACKUP_IDX_COUNTERS,
+	STORAGE_BACKUP_IDX_RESETS,
+	STORAGE_BACKUP_IDX_LAST
+} STORAGE_backup_idx_t;
+
+typedef struct {
+	unsigned char enable;
+	unsigned int standby_count;
+} STORAGE_context_t;
+
+/*** STORAGE local global variables ***/
+
+static STORAGE_context_t storage_ctx;
+
+/*** STORAGE local functions ***/
+
+/* LIMIT AN UNSIGNED VALUE TO ITS FIELD WIDTH.
+ * @param value:	Value to store.
+ * @param max:		Maximum value of the field.
+ * @return:			Saturated value.
+ */
+static unsigned int STORAGE_saturate(unsigned int value, unsigned int max) {
+	return (value > max) ? max : value;
+}
+
+/*** STORAGE functions ***/
+
+/* READ STORAGE SETTINGS KEPT IN BACKUP REGISTERS (MUST BE CALLED BEFORE RTC RESET).
+ * @param:	None.
+ * @return:	1 if the MCU is waking-up from storage mode, 0 otherwise.
+ */
+unsigned char STORAGE_init(void) {
+	// Local variables.
+	unsigned char standby_flag = PWR_get_standby_flag();
+	unsigned int header = RTC_read_backup_register(STORAGE_BACKUP_IDX_HEADER);
+	// Backup registers are cleared on power-on.
+	storage_ctx.enable = 0;
+	storage_ctx.standby_count = 0;
+	if ((header & STORAGE_MAGIC_MASK) != STORAGE_MAGIC) return 0;
+	storage_ctx.enable = ((header & STORAGE_FLAG_ENABLE) != 0) ? 1 : 0;
+	storage_ctx.standby_count = (RTC_read_backup_register(STORAGE_BACKUP_IDX_COUNTERS) >> 16);
+	return standby_flag;
+}
+
+/* ENABLE OR DISABLE STORAGE MODE.
+ * @param enable:	Allow standby mode when idle if non zero.
+ * @return:			None.
+ */
+void STORAGE_set_enable(unsigned char enable) {
+	storage_ctx.enable = (enable != 0) ? 1 : 0;
+}
+
+/* GET STORAGE MODE SETTING.
+ * @param:	None.
+ * @return:	1 if storage mode is enabled, 0 otherwise.
+ */
+unsigned char STORAGE_get_enable(void) {
+	return storage_ctx.enable;
+}
+
+/* GET NUMBER OF WAKE-UPS FROM STORAGE MODE.
+ * @param:	None.
+ * @return:	Number of wake-ups since storage mode was first entered.
+ */
+unsigned int STORAGE_get_standby_count(void) {
+	return storage_ctx.standby_count;
+}
+
+/* RESET NUMBER OF WAKE-UPS FROM STORAGE MODE.
+ * @param:	None.
+ * @return:	None.
+ */
+void STORAGE_clear_standby_count(void) {
+	storage_ctx.standby_count = 0;
+}
+
+/* RESTORE CONTEXT SAVED BEFORE ENTERING STORAGE MODE (AFTER MODULES INIT).
+ * @param:	None.
+ * @return:	None.
+ */
+void STORAGE_restore_context(void) {
+	// Local variables.
+	unsigned int header = RTC_read_backup_register(STORAGE_BACKUP_IDX_HEADER);
+	unsigned int settings = RTC_read_backup_register(STORAGE_BACKUP_IDX_SETTINGS);
+#ifdef ANOMALY_DETECTION
+	unsigned int counters = RTC_read_backup_register(STORAGE_BACKUP_IDX_COUNTERS);
+#endif
+#ifdef RETAINED_DATA
+	unsigned int resets = RTC_read_backup_register(STORAGE_BACKUP_IDX_RESETS);
+	unsigned char idx = 0;
+#endif
+	// Calibration and retained data.
+	RCC_set_msi_trim((signed char) (settings & STORAGE_MSI_TRIM_MASK));
+#ifdef RETAINED_DATA
+	NOINIT_restore_energy(RTC_read_backup_register(STORAGE_BACKUP_IDX_ENERGY_MJ));
+	for (idx=0 ; idx<NOINIT_RESET_SOURCE_LAST ; idx++) {
+		NOINIT_restore_reset_count(idx, ((resets >> (8 * idx)) & STORAGE_COUNT_8_MAX));
+	}
+#endif
+#ifdef ANOMALY_DETECTION
+	ANOMALY_set_iout_offset((unsigned int) ((int) ((signed short) (counters & STORAGE_COUNT_16_MAX))));
+	ANOMALY_set_sigma_threshold((unsigned char) ((header & STORAGE_SIGMA_MASK) >> STORAGE_SIGMA_SHIFT));
+#endif
+	// User settings.
+	LED_set_load_period(header & STORAGE_LED_PERIOD_MASK);
+#ifdef ALARM_PUSH
+	AT_set_alarm_push(((header & STORAGE_FLAG_ALARM_PUSH) != 0) ? 1 : 0);
+#endif
+#ifdef ENERGY_GOVERNOR
+	GOVERNOR_set_target(settings >> STORAGE_TARGET_SHIFT);
+#endif
+	storage_ctx.standby_count = STORAGE_saturate(storage_ctx.standby_count + 1, STORAGE_COUNT_16_MAX);
+}
+
+/* SAVE CONTEXT AND ENTER STANDBY MODE (WAKE-UP IS A RESET).
+ * @param wakeup_period_seconds:	Delay before next wake-up (must be lower than watchdog period).
+ * @return:							None.
+ */
+void STORAGE_enter(unsigned int wakeup_period_seconds) {
+	// Local variables.
+#ifdef RETAINED_DATA
+	NOINIT_data_t noinit_data;
+	unsigned int resets = 0;
+	unsigned char idx = 0;
+#endif
+	int iout_offset_ua = 0;
+	unsigned int target_ua = 0;
+	unsigned int header = STORAGE_MAGIC;
+	// Save context.
+#ifdef RETAINED_DATA
+	NOINIT_get_data(&noinit_data);
+	RTC_write_backup_register(STORAGE_BACKUP_IDX_ENERGY_MJ, noinit_data.energy_mj);
+	for (idx=0 ; idx<NOINIT_RESET_SOURCE_LAST ; idx++) {
+		resets |= (STORAGE_saturate(noinit_data.reset_count[idx], STORAGE_COUNT_8_MAX) << (8 * idx));
+	}
+	RTC_write_backup_register(STORAGE_BACKUP_IDX_RESETS, resets);
+#endif
+#ifdef ENERGY_GOVERNOR
+	target_ua = STORAGE_saturate(GOVERNOR_get_target(), STORAGE_TARGET_MAX);
+#endif
+	RTC_write_backup_register(STORAGE_BACKUP_IDX_SETTINGS, (target_ua << STORAGE_TARGET_SHIFT) | ((unsigned char) RCC_get_msi_trim()));
+#ifdef ANOMALY_DETECTION
+	iout_offset_ua = (int) ANOMALY_get_iout_offset();
+	header |= ((((unsigned int) ANOMALY_get_sigma_threshold()) << STORAGE_SIGMA_SHIFT) & STORAGE_SIGMA_MASK);
+#endif
+	if (iout_offset_ua < STORAGE_OFFSET_MIN) iout_offset_ua = STORAGE_OFFSET_MIN;
+	if (iout_offset_ua > STORAGE_OFFSET_MAX) iout_offset_ua = STORAGE_OFFSET_MAX;
+	RTC_write_backup_register(STORAGE_BACKUP_IDX_COUNTERS, (storage_ctx.standby_count << 16) | (((unsigned int) iout_offset_ua) & STORAGE_COUNT_16_MAX));
+	// Header is written last.
+	if (storage_ctx.enable != 0) header |= STORAGE_FLAG_ENABLE;
+#ifdef ALARM_PUSH
+	if (AT_get_alarm_push() != 0) header |= STORAGE_FLAG_ALARM_PUSH;
+#endif
+	header |= STORAGE_saturate(LED_get_load_period(), STORAGE_LED_PERIOD_MASK);
+	RTC_write_backup_register(STORAGE_BACKUP_IDX_HEADER, header);
+	// Enter standby mode.
+	RTC_restart_wakeup_timer(wakeup_period_seconds);
+	PWR_enter_standby_mode();
+}
+#endif
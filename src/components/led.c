@@ -9,8 +9,31 @@
 
 #include "gpio.h"
 #include "mapping.h"
+#include "rtc.h"
 #include "tim.h"
 
+/*** LED local macros ***/
+
+#define LED_ACTIVITY_BLINK_DURATION_MS		100
+#define LED_ACTIVITY_BLINK_COLOR			TIM2_CHANNEL_MASK_BLUE
+#define LED_ACTIVITY_MIN_INTERVAL_SECONDS	1 // Activity requests within the same interval are coalesced.
+#define LED_LOAD_BLINK_DURATION_MS			2000
+
+/*** LED local structures ***/
+
+typedef struct {
+	unsigned char active;
+	unsigned char activity_pending;
+	unsigned int activity_timestamp_seconds;
+	TIM2_channel_mask_t load_color;
+	unsigned int load_period_seconds;
+	unsigned char load_scheduled;
+} LED_context_t;
+
+/*** LED local global variables ***/
+
+static LED_context_t led_ctx;
+
 /*** LED local functions ***/
 
 /* TURN LED OFF.
@@ -27,6 +50,24 @@ static void LED_off(void) {
 	GPIO_write(&GPIO_LED_BLUE, 1);
 }
 
+/* START OR STOP LOAD BLINKS TIMER ACCORDING TO CURRENT SETTINGS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LED_update_load_schedule(void) {
+	// Load blinks are scheduled with RTC alarm, independently of the measurement wake-ups.
+	if ((led_ctx.load_period_seconds != 0) && (led_ctx.load_color != TIM2_CHANNEL_MASK_OFF)) {
+		if (led_ctx.load_scheduled == 0) {
+			RTC_start_alarm(led_ctx.load_period_seconds);
+			led_ctx.load_scheduled = 1;
+		}
+	}
+	else if (led_ctx.load_scheduled != 0) {
+		RTC_stop_alarm();
+		led_ctx.load_scheduled = 0;
+	}
+}
+
 /*** LED functions ***/
 
 /* INIT LED.
@@ -34,6 +75,15 @@ static void LED_off(void) {
  * @return:	None.
  */
 void LED_init(void) {
+	// Init context.
+	led_ctx.active = 0;
+	led_ctx.activity_pending = 0;
+	led_ctx.activity_timestamp_seconds = 0;
+	led_ctx.load_color = TIM2_CHANNEL_MASK_OFF;
+	led_ctx.load_period_seconds = LED_LOAD_PERIOD_DEFAULT_SECONDS;
+	led_ctx.load_scheduled = 0;
+	RTC_stop_alarm();
+	// Turn LED off.
 	LED_off();
 }
 
@@ -43,16 +93,36 @@ void LED_init(void) {
  * @return:					None.
  */
 void LED_single_blink(unsigned int blink_duration_ms, TIM2_channel_mask_t color) {
+	// Start blink.
+	LED_start_single_blink(blink_duration_ms, color);
+	// Wait the end of blink.
+	while (TIM21_IsSingleBlinkDone() == 0);
+	// Release peripherals.
+	LED_stop();
+}
+
+/* START A SINGLE LED BLINK WITHOUT WAITING FOR ITS END.
+ * @param blink_period_ms:	Blink duration in ms.
+ * @param led_color:		Color to set.
+ * @return:					None.
+ */
+void LED_start_single_blink(unsigned int blink_duration_ms, TIM2_channel_mask_t color) {
 	// Init required peripheral.
 	TIM2_init();
 	TIM21_init(blink_duration_ms);
-	// Set color according to thresholds.
+	// Set color.
 	TIM2_set_color_mask(color);
 	// Start blink.
 	TIM2_start();
 	TIM21_Start();
-	// Wait the end of blink.
-	while (TIM21_IsSingleBlinkDone() == 0);
+	led_ctx.active = 1;
+}
+
+/* ABORT CURRENT BLINK AND RELEASE TIMERS.
+ * @param:	None.
+ * @return:	None.
+ */
+void LED_stop(void) {
 	// Stop timers.
 	TIM2_stop();
 	TIM21_Stop();
@@ -61,5 +131,83 @@ void LED_single_blink(unsigned int blink_duration_ms, TIM2_channel_mask_t color)
 	TIM21_disable();
 	// Turn LED off.
 	LED_off();
+	led_ctx.active = 0;
 }
 
+/* CHECK IF A BLINK IS RUNNING.
+ * @param:	None.
+ * @return:	1 if timers are running (stop mode is not allowed), 0 otherwise.
+ */
+unsigned char LED_is_active(void) {
+	return led_ctx.active;
+}
+
+/* REQUEST AN ACTIVITY BLINK.
+ * @param:	None.
+ * @return:	None.
+ */
+void LED_notify_activity(void) {
+	led_ctx.activity_pending = 1;
+}
+
+/* SET LOAD INDICATION COLOR.
+ * @param color:	Color of the next load blinks.
+ * @return:			None.
+ */
+void LED_set_load_color(TIM2_channel_mask_t color) {
+	led_ctx.load_color = color;
+	LED_update_load_schedule();
+}
+
+/* SET LOAD INDICATION CADENCE.
+ * @param load_period_seconds:	Period between load blinks in seconds (0 to disable load indication).
+ * @return:						None.
+ */
+void LED_set_load_period(unsigned int load_period_seconds) {
+	if (load_period_seconds == led_ctx.load_period_seconds) return;
+	led_ctx.load_period_seconds = load_period_seconds;
+	// Restart cadence with the new period.
+	if (led_ctx.load_scheduled != 0) {
+		RTC_stop_alarm();
+		led_ctx.load_scheduled = 0;
+	}
+	LED_update_load_schedule();
+}
+
+/* GET LOAD INDICATION CADENCE.
+ * @param:	None.
+ * @return:	Period between load blinks in seconds (0 if load indication is disabled).
+ */
+unsigned int LED_get_load_period(void) {
+	return led_ctx.load_period_seconds;
+}
+
+/* MAIN TASK OF LED INDICATION POLICY.
+ * @param:	None.
+ * @return:	None.
+ */
+void LED_task(void) {
+	// Local variables.
+	unsigned int uptime_seconds = 0;
+	// Release timers at the end of the current blink.
+	if (led_ctx.active != 0) {
+		if (TIM21_IsSingleBlinkDone() == 0) return;
+		LED_stop();
+	}
+	uptime_seconds = RTC_get_uptime_seconds();
+	// Load indication has priority since it is the least frequent.
+	if (RTC_get_alarm_flag() != 0) {
+		RTC_clear_alarm_flag();
+		if (led_ctx.load_scheduled != 0) {
+			RTC_start_alarm(led_ctx.load_period_seconds);
+			LED_start_single_blink(LED_LOAD_BLINK_DURATION_MS, led_ctx.load_color);
+			// Pending activity is coalesced into the load blink.
+			led_ctx.activity_pending = 0;
+		}
+	}
+	else if ((led_ctx.activity_pending != 0) && ((uptime_seconds - led_ctx.activity_timestamp_seconds) >= LED_ACTIVITY_MIN_INTERVAL_SECONDS)) {
+		LED_start_single_blink(LED_ACTIVITY_BLINK_DURATION_MS, LED_ACTIVITY_BLINK_COLOR);
+		led_ctx.activity_timestamp_seconds = uptime_seconds;
+		led_ctx.activity_pending = 0;
+	}
+}
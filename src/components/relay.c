@@ -10,6 +10,10 @@
 #include "gpio.h"
 #include "mapping.h"
 
+/*** RELAY local global variables ***/
+
+static unsigned char relay_state;
+
 /**** RELAY functions ***/
 
 /* INIT RELAY INTERFACE.
@@ -19,6 +23,7 @@
 void RELAY_init(void) {
 	// Init GPIO.
 	GPIO_configure(&GPIO_OUT_EN, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	relay_state = 0;
 }
 
 /* SET RELAY STATE.
@@ -28,4 +33,13 @@ void RELAY_init(void) {
 void RELAY_set_state(unsigned char enable) {
 	// Set GPIO.
 	GPIO_write(&GPIO_OUT_EN, enable);
+	relay_state = (enable != 0) ? 1 : 0;
+}
+
+/* GET RELAY STATE.
+ * @param:	None.
+ * @return:	1 if the relay is closed, 0 otherwise.
+ */
+unsigned char RELAY_get_state(void) {
+	return relay_state;
 }
@@ -6,30 +6,74 @@
  */
 
 #include "adc.h"
+#include "anomaly.h"
 #include "at.h"
+#include "boot.h"
 #include "exti.h"
 #include "gpio.h"
+#include "governor.h"
 #include "iwdg.h"
 #include "led.h"
 #include "lptim.h"
 #include "lpuart.h"
 #include "mapping.h"
+#include "mode.h"
+#include "noinit.h"
 #include "nvic.h"
+#include "nvm.h"
 #include "pwr.h"
 #include "rcc.h"
 #include "relay.h"
 #include "rtc.h"
+#include "storage.h"
+#include "systick.h"
 #include "tim.h"
 
 /*** MAIN local macros ***/
 
-#define LVRM_NUMBER_OF_IOUT_THRESHOLD	6
+#define LVRM_NUMBER_OF_IOUT_THRESHOLD		6
+#define LVRM_COALESCING_TOLERANCE_SECONDS	2 // Merge next measurement into a command wake-up when due within this delay (0 to disable).
+#define LVRM_FOLLOW_UP_ACQUISITIONS			3 // Number of fast acquisitions after a relay state change.
+#define LVRM_FOLLOW_UP_PERIOD_SECONDS		1
+#define LVRM_WAKEUP_PERIOD_MAX_SECONDS		15 // IWDG period is 4095 * 256 / LSI = 18.7s with a 56kHz worst case LSI.
+#define LVRM_STORAGE_IDLE_SECONDS			60 // Bus inactivity before entering storage mode.
+#define LVRM_STORAGE_WAKEUP_PERIOD_SECONDS	LVRM_WAKEUP_PERIOD_MAX_SECONDS
+#define LVRM_ALARM_VOUT_DROP_PERCENT		10 // Output voltage drop from input above which undervoltage alarm is latched.
 
 /*** MAIN structures ***/
 
 typedef struct {
 	TIM2_channel_mask_t led_color;
 	unsigned int iout_ua;
+#ifdef MSI_CALIBRATION
+	unsigned int msi_calibration_wakeup_count;
+#endif
+	unsigned int measurement_wakeup_count;
+	unsigned char adc_data_mask;
+	unsigned int vout_mv;
+	unsigned int vin_mv;
+	unsigned int adc_timestamp_seconds;
+#ifdef RETAINED_DATA
+	unsigned int energy_timestamp_seconds;
+#endif
+	unsigned int next_measurement_seconds;
+	unsigned char command_pending;
+#ifdef ENERGY_GOVERNOR
+	unsigned int awake_start_count;
+#endif
+	unsigned int measurement_period_seconds;
+	unsigned int wakeup_period_seconds;
+	unsigned char measurement_wakeups; // Number of RTC wake-ups per measurement period.
+	unsigned char wakeup_count;
+#ifdef ENERGY_GOVERNOR
+	unsigned char governor_level;
+#endif
+	unsigned char relay_state;
+	unsigned char follow_up_count;
+#ifdef STORAGE_MODE
+	unsigned int activity_timestamp_seconds;
+	unsigned int storage_idle_seconds;
+#endif
 } LVRM_context_t;
 
 /*** MAIN local global variables ***/
@@ -51,6 +95,20 @@ static const TIM2_channel_mask_t lvrm_iout_led_color[LVRM_NUMBER_OF_IOUT_THRESHO
 		TIM2_CHANNEL_MASK_CYAN,
 		TIM2_CHANNEL_MASK_WHITE
 };
+// Measurement period of each ADC data, in number of RTC wake-ups.
+static const unsigned char lvrm_adc_data_period[ADC_DATA_IDX_ACQUIRED_MAX] = {
+		12, // VIN.
+		1, // VOUT.
+		1, // IOUT.
+		12 // VMCU.
+};
+// Measurement period while the relay is open (output is only checked for leakage).
+static const unsigned char lvrm_adc_data_period_idle[ADC_DATA_IDX_ACQUIRED_MAX] = {
+		12, // VIN.
+		12, // VOUT.
+		12, // IOUT.
+		12 // VMCU.
+};
 static LVRM_context_t lvrm_ctx;
 
 /*** MAIN local functions ***/
@@ -73,6 +131,231 @@ static void LVRM_update_led_color(void) {
 	}
 }
 
+/* COMPUTE THE MASK OF ADC DATA DUE AT CURRENT WAKE-UP.
+ * @param:					None.
+ * @return adc_data_mask:	Bit mask of the data to acquire.
+ */
+static unsigned char LVRM_get_adc_data_mask(void) {
+	// Local variables.
+	unsigned char adc_data_mask = 0;
+	const unsigned char* adc_data_period = (lvrm_ctx.relay_state != 0) ? lvrm_adc_data_period : lvrm_adc_data_period_idle;
+	unsigned char idx = 0;
+	// Follow-up acquisitions only capture the output and do not shift the regular schedule.
+	if (lvrm_ctx.follow_up_count != 0) {
+		lvrm_ctx.follow_up_count--;
+		return ((0b1 << ADC_DATA_IDX_VOUT_MV) | (0b1 << ADC_DATA_IDX_IOUT_UA));
+	}
+	// Check each data period.
+	for (idx=0 ; idx<ADC_DATA_IDX_ACQUIRED_MAX ; idx++) {
+		if ((lvrm_ctx.measurement_wakeup_count % adc_data_period[idx]) == 0) {
+			adc_data_mask |= (0b1 << idx);
+		}
+	}
+	lvrm_ctx.measurement_wakeup_count++;
+	return adc_data_mask;
+}
+
+/* GET CURRENT RTC WAKE-UP PERIOD.
+ * @param:	None.
+ * @return:	Wake-up period in seconds.
+ */
+static unsigned int LVRM_get_wakeup_period(void) {
+	return (lvrm_ctx.follow_up_count != 0) ? LVRM_FOLLOW_UP_PERIOD_SECONDS : lvrm_ctx.wakeup_period_seconds;
+}
+
+/* GET DELAY UNTIL NEXT MEASUREMENT.
+ * @param:	None.
+ * @return:	Measurement period in seconds.
+ */
+static unsigned int LVRM_get_measurement_period(void) {
+	return (lvrm_ctx.follow_up_count != 0) ? LVRM_FOLLOW_UP_PERIOD_SECONDS : lvrm_ctx.measurement_period_seconds;
+}
+
+/* SET MEASUREMENT PERIOD.
+ * @param measurement_period_seconds:	New period in seconds.
+ * @return:								None.
+ * Periods longer than the watchdog allows are split into several RTC wake-ups, only the last one performs measurements.
+ */
+static void LVRM_set_measurement_period(unsigned int measurement_period_seconds) {
+	lvrm_ctx.measurement_wakeups = (measurement_period_seconds + LVRM_WAKEUP_PERIOD_MAX_SECONDS - 1) / LVRM_WAKEUP_PERIOD_MAX_SECONDS;
+	lvrm_ctx.wakeup_period_seconds = measurement_period_seconds / lvrm_ctx.measurement_wakeups;
+	lvrm_ctx.measurement_period_seconds = (lvrm_ctx.wakeup_period_seconds * lvrm_ctx.measurement_wakeups);
+}
+
+#ifdef ENERGY_GOVERNOR
+/* APPLY ENERGY GOVERNOR SETTINGS WHEN ITS LEVEL CHANGED.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LVRM_apply_governor_settings(void) {
+	// Local variables.
+	GOVERNOR_settings_t governor_settings;
+	// Keep manual settings as long as the level does not change.
+	if (GOVERNOR_get_level() == lvrm_ctx.governor_level) return;
+	lvrm_ctx.governor_level = GOVERNOR_get_level();
+	GOVERNOR_get_settings(&governor_settings);
+	// Measurement period (periods expressed in wake-ups are stretched accordingly).
+	if (governor_settings.measurement_period_seconds != lvrm_ctx.measurement_period_seconds) {
+		LVRM_set_measurement_period(governor_settings.measurement_period_seconds);
+		// New period is applied at the end of a follow-up sequence.
+		if (lvrm_ctx.follow_up_count == 0) {
+			RTC_restart_wakeup_timer(lvrm_ctx.wakeup_period_seconds);
+			lvrm_ctx.wakeup_count = 0;
+			lvrm_ctx.next_measurement_seconds = RTC_get_uptime_seconds() + lvrm_ctx.measurement_period_seconds;
+		}
+	}
+	LED_set_load_period(governor_settings.led_period_seconds);
+}
+#endif
+
+/* PERFORM MEASUREMENTS AND ASSOCIATED PROCESSING.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LVRM_perform_periodic_tasks(void) {
+	// Local variables.
+	unsigned char follow_up = (lvrm_ctx.follow_up_count != 0) ? 1 : 0;
+	// Schedule next deadline (RTC wake-up timer period starts now).
+	lvrm_ctx.wakeup_count = 0;
+	lvrm_ctx.next_measurement_seconds = RTC_get_uptime_seconds() + LVRM_get_measurement_period();
+#ifdef MSI_CALIBRATION
+	// Track MSI drift (TIM21 is shared with LED blink).
+	if (follow_up == 0) {
+		lvrm_ctx.msi_calibration_wakeup_count++;
+	}
+	if ((lvrm_ctx.msi_calibration_wakeup_count >= RCC_MSI_CALIBRATION_PERIOD_WAKEUPS) && (LED_is_active() == 0)) {
+		RCC_calibrate_msi(1);
+		lvrm_ctx.msi_calibration_wakeup_count = 0;
+	}
+#endif
+	// Perform analog measurements.
+	lvrm_ctx.adc_data_mask = LVRM_get_adc_data_mask();
+	ADC1_enable();
+	ADC1_perform_measurements(lvrm_ctx.adc_data_mask);
+	ADC1_disable();
+	// Only convert the data used by the periodic tasks.
+	ADC1_get_data(ADC_DATA_IDX_IOUT_UA, &lvrm_ctx.iout_ua);
+	ADC1_get_data(ADC_DATA_IDX_VOUT_MV, &lvrm_ctx.vout_mv);
+	lvrm_ctx.adc_timestamp_seconds = ADC1_get_timestamp_seconds();
+	if (lvrm_ctx.relay_state == 0) {
+#ifdef ANOMALY_DETECTION
+		// Open relay: only learn sensor offset and check for leakage (not during the turn-off transient).
+		if ((follow_up == 0) && ((lvrm_ctx.adc_data_mask & ((0b1 << ADC_DATA_IDX_VOUT_MV) | (0b1 << ADC_DATA_IDX_IOUT_UA))) == ((0b1 << ADC_DATA_IDX_VOUT_MV) | (0b1 << ADC_DATA_IDX_IOUT_UA)))) {
+			ANOMALY_process_idle(lvrm_ctx.iout_ua, lvrm_ctx.vout_mv);
+#ifdef ALARM_PUSH
+			if ((ANOMALY_get_status() & (0b1 << ANOMALY_STATUS_BIT_LEAKAGE)) != 0) {
+				AT_latch_alarm(AT_ALARM_LEAKAGE);
+			}
+#endif
+		}
+#endif
+		LED_set_load_color(TIM2_CHANNEL_MASK_OFF);
+	}
+	else {
+#ifdef ANOMALY_DETECTION
+		// Remove learned sensor offset.
+		lvrm_ctx.iout_ua = (lvrm_ctx.iout_ua > ANOMALY_get_iout_offset()) ? (lvrm_ctx.iout_ua - ANOMALY_get_iout_offset()) : 0;
+		// Check output current against learned baseline (transient follow-up samples would pollute it).
+		if (((lvrm_ctx.adc_data_mask & (0b1 << ADC_DATA_IDX_IOUT_UA)) != 0) && (follow_up == 0)) {
+			if (ANOMALY_process(lvrm_ctx.iout_ua, lvrm_ctx.adc_timestamp_seconds) != 0) {
+#ifdef ALARM_PUSH
+				AT_latch_alarm(((ANOMALY_get_status() & (0b1 << ANOMALY_STATUS_BIT_LAST_HIGH)) != 0) ? AT_ALARM_OVERCURRENT : AT_ALARM_UNDERCURRENT);
+#endif
+			}
+		}
+#endif
+#ifdef ALARM_PUSH
+		// Check output voltage against last input voltage (once settled).
+		if (((lvrm_ctx.adc_data_mask & (0b1 << ADC_DATA_IDX_VOUT_MV)) != 0) && (follow_up == 0)) {
+			ADC1_get_data(ADC_DATA_IDX_VIN_MV, &lvrm_ctx.vin_mv);
+			if ((lvrm_ctx.vout_mv * 100) < (lvrm_ctx.vin_mv * (100 - LVRM_ALARM_VOUT_DROP_PERCENT))) {
+				AT_latch_alarm(AT_ALARM_UNDERVOLTAGE);
+			}
+		}
+#endif
+#ifdef RETAINED_DATA
+		// Accumulate output energy in retained RAM.
+		if ((lvrm_ctx.adc_data_mask & ((0b1 << ADC_DATA_IDX_VOUT_MV) | (0b1 << ADC_DATA_IDX_IOUT_UA))) == ((0b1 << ADC_DATA_IDX_VOUT_MV) | (0b1 << ADC_DATA_IDX_IOUT_UA))) {
+			NOINIT_add_energy(lvrm_ctx.vout_mv, lvrm_ctx.iout_ua, (lvrm_ctx.adc_timestamp_seconds - lvrm_ctx.energy_timestamp_seconds));
+			lvrm_ctx.energy_timestamp_seconds = lvrm_ctx.adc_timestamp_seconds;
+		}
+#endif
+		// Compute LED color according to output current.
+		LVRM_update_led_color();
+		LED_set_load_color(lvrm_ctx.led_color);
+	}
+	// Back to regular period after the last follow-up acquisition.
+	if ((follow_up != 0) && (lvrm_ctx.follow_up_count == 0)) {
+		RTC_restart_wakeup_timer(lvrm_ctx.wakeup_period_seconds);
+		lvrm_ctx.next_measurement_seconds = RTC_get_uptime_seconds() + lvrm_ctx.measurement_period_seconds;
+	}
+	// Prepare status response.
+	AT_update_status_frame();
+#ifdef ENERGY_GOVERNOR
+	// Update energy budget.
+	GOVERNOR_task(RTC_get_uptime_seconds());
+	LVRM_apply_governor_settings();
+#endif
+}
+
+/* START FAST ACQUISITIONS WHEN RELAY STATE CHANGED.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LVRM_check_relay_state(void) {
+	// Local variables.
+	unsigned char relay_state = RELAY_get_state();
+	if (relay_state == lvrm_ctx.relay_state) return;
+	lvrm_ctx.relay_state = relay_state;
+#ifdef RETAINED_DATA
+	// Energy was not accumulated while open.
+	lvrm_ctx.energy_timestamp_seconds = RTC_get_uptime_seconds();
+#endif
+	// Capture the transition with a short wake-up period.
+	lvrm_ctx.follow_up_count = LVRM_FOLLOW_UP_ACQUISITIONS;
+	RTC_restart_wakeup_timer(LVRM_FOLLOW_UP_PERIOD_SECONDS);
+	lvrm_ctx.next_measurement_seconds = RTC_get_uptime_seconds() + LVRM_FOLLOW_UP_PERIOD_SECONDS;
+	AT_update_status_frame();
+}
+
+#ifdef STORAGE_MODE
+/* CHECK IF STORAGE MODE CAN BE ENTERED.
+ * @param:	None.
+ * @return:	1 if the node is idle with output disabled, 0 otherwise.
+ */
+static unsigned char LVRM_is_storage_allowed(void) {
+	// Output enable pin is not driven in standby mode.
+	if ((STORAGE_get_enable() == 0) || (lvrm_ctx.relay_state != 0) || (lvrm_ctx.follow_up_count != 0)) return 0;
+	return ((RTC_get_uptime_seconds() - lvrm_ctx.activity_timestamp_seconds) >= lvrm_ctx.storage_idle_seconds);
+}
+#endif
+
+#ifdef RETAINED_DATA
+/* COUNT WARM RESETS IN RETAINED RAM.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LVRM_record_reset(void) {
+	// Local variables.
+	unsigned char reset_flags = RCC_get_reset_flags();
+	// Nothing to record after power-on since retained data was lost.
+	if (NOINIT_init() == 0) return;
+	// Pin flag is also set by internal resets so check it last.
+	if ((reset_flags & RCC_RESET_FLAG_IWDG) != 0) {
+		NOINIT_record_reset(NOINIT_RESET_SOURCE_IWDG);
+	}
+	else if ((reset_flags & RCC_RESET_FLAG_SOFTWARE) != 0) {
+		NOINIT_record_reset(NOINIT_RESET_SOURCE_SOFTWARE);
+	}
+	else if ((reset_flags & RCC_RESET_FLAG_LOW_POWER) != 0) {
+		NOINIT_record_reset(NOINIT_RESET_SOURCE_LOW_POWER);
+	}
+	else if ((reset_flags & RCC_RESET_FLAG_PIN) != 0) {
+		NOINIT_record_reset(NOINIT_RESET_SOURCE_PIN);
+	}
+}
+#endif
+
 /*** MAIN function ***/
 
 /* MAIN FUNCTION.
@@ -80,12 +363,25 @@ static void LVRM_update_led_color(void) {
  * @return:	None.
  */
 int main(void) {
+	// Local variables.
+	unsigned char storage_resume = 0;
+	// Start timestamp counter first to profile boot.
+	SYSTICK_init();
+	BOOT_INIT();
 	// Init memory.
 	NVIC_init();
+#ifdef RETAINED_DATA
+	LVRM_record_reset();
+#endif
 	// Init power and clock modules.
 	PWR_init();
+#ifdef STORAGE_MODE
+	storage_resume = STORAGE_init();
+#endif
+	BOOT_SET_STORAGE_RESUME(storage_resume);
 	RCC_init();
 	RCC_enable_lsi();
+	BOOT_END_PHASE(BOOT_PHASE_CLOCKS);
 	// Init watchdog.
 #ifndef DEBUG
 	IWDG_init();
@@ -93,40 +389,138 @@ int main(void) {
 	// Init GPIOs.
 	GPIO_init();
 	EXTI_init();
-	// Init RTC.
-	RTC_reset();
-	RCC_enable_lse();
-	RTC_init();
+	BOOT_END_PHASE(BOOT_PHASE_GPIO);
+	// Calendar, LSE and MSI trimming are kept when waking-up from storage mode.
+	if (storage_resume != 0) {
+		RTC_resume();
+		BOOT_END_PHASE(BOOT_PHASE_RTC);
+	}
+	else {
+		// Init RTC.
+		RTC_reset();
+		RCC_enable_lse();
+		BOOT_END_PHASE(BOOT_PHASE_LSE);
+		RTC_init();
+		BOOT_END_PHASE(BOOT_PHASE_RTC);
+#ifdef MSI_CALIBRATION
+		// Trim MSI against LSE.
+		RCC_calibrate_msi(RCC_MSI_CALIBRATION_BOOT_STEPS);
+		BOOT_END_PHASE(BOOT_PHASE_MSI_CALIBRATION);
+#endif
+	}
+	BOOT_SET_RTC_CLOCK_SOURCE(RTC_get_clock_source());
+#ifdef MSI_CALIBRATION
+	lvrm_ctx.msi_calibration_wakeup_count = 0;
+#endif
+	lvrm_ctx.measurement_wakeup_count = 0;
+#ifdef RETAINED_DATA
+	lvrm_ctx.energy_timestamp_seconds = 0;
+#endif
 	// Init peripherals.
 	LPTIM1_init();
 	LPUART1_init();
+#ifdef NVM_QUEUE
+	NVM_init();
+#endif
+	BOOT_END_PHASE(BOOT_PHASE_PERIPHERALS);
 	ADC1_init();
+	BOOT_END_PHASE(BOOT_PHASE_ADC);
 	// Init components.
 	LED_init();
 	RELAY_init();
-	// Init AT interface.
+	// Init applicative layers.
+#ifdef ANOMALY_DETECTION
+	ANOMALY_init();
+#endif
 	AT_init();
-	// Start periodic wakeup timer.
-	RTC_start_wakeup_timer(RTC_WAKEUP_PERIOD_SECONDS);
+#ifdef ENERGY_GOVERNOR
+	GOVERNOR_init(RTC_get_uptime_seconds());
+#endif
+#ifdef STORAGE_MODE
+	if (storage_resume != 0) {
+		STORAGE_restore_context();
+	}
+#endif
+	AT_update_status_frame();
+	// Start periodic wakeup timer (the standby period is still running after a resume).
+	if (storage_resume != 0) {
+		RTC_restart_wakeup_timer(RTC_WAKEUP_PERIOD_SECONDS);
+	}
+	else {
+		RTC_start_wakeup_timer(RTC_WAKEUP_PERIOD_SECONDS);
+	}
+	LVRM_set_measurement_period(RTC_WAKEUP_PERIOD_SECONDS);
+	lvrm_ctx.wakeup_count = 0;
+	lvrm_ctx.next_measurement_seconds = RTC_get_uptime_seconds() + lvrm_ctx.measurement_period_seconds;
+	lvrm_ctx.command_pending = 0;
+	lvrm_ctx.relay_state = RELAY_get_state();
+	lvrm_ctx.follow_up_count = 0;
+#ifdef STORAGE_MODE
+	// After a storage wake-up, only listen to the bus until next RTC wake-up.
+	lvrm_ctx.activity_timestamp_seconds = RTC_get_uptime_seconds();
+	lvrm_ctx.storage_idle_seconds = (storage_resume != 0) ? 0 : LVRM_STORAGE_IDLE_SECONDS;
+#endif
+	BOOT_END_PHASE(BOOT_PHASE_APPLICATION);
+#ifdef ENERGY_GOVERNOR
+	lvrm_ctx.governor_level = 0;
+	lvrm_ctx.awake_start_count = SYSTICK_get_count();
+#endif
 	// Main loop.
 	while (1) {
 		IWDG_reload();
-		// Enter stop mode.
-		PWR_enter_stop_mode();
+#ifdef ENERGY_GOVERNOR
+		// Account run time (SysTick is stopped in stop mode).
+		GOVERNOR_add_residency(GOVERNOR_RESIDENCY_RUN, SYSTICK_convert_to_us(SYSTICK_get_elapsed(lvrm_ctx.awake_start_count)));
+		// Enter stop mode unless LED timers are running.
+		if (LED_is_active() != 0) {
+			lvrm_ctx.awake_start_count = SYSTICK_get_count();
+			PWR_enter_sleep_mode();
+			GOVERNOR_add_residency(GOVERNOR_RESIDENCY_SLEEP, SYSTICK_convert_to_us(SYSTICK_get_elapsed(lvrm_ctx.awake_start_count)));
+		}
+		else {
+			PWR_enter_stop_mode();
+		}
+		lvrm_ctx.awake_start_count = SYSTICK_get_count();
+#else
+		// Enter stop mode unless LED timers are running.
+		if (LED_is_active() != 0) {
+			PWR_enter_sleep_mode();
+		}
+		else {
+			PWR_enter_stop_mode();
+		}
+#endif
 		// Check source.
 		if (RTC_get_wakeup_timer_flag() != 0) {
-			// Wake-up by RTC: clear flag and blink LED.
+			// Wake-up by RTC: clear flag.
 			RTC_clear_wakeup_timer_flag();
-			// Perform analog measurements.
-			ADC1_enable();
-			ADC1_perform_measurements();
-			ADC1_disable();
-			ADC1_get_data(ADC_DATA_IDX_IOUT_UA, &lvrm_ctx.iout_ua);
-			// Compute LED color according to output current.
-			LVRM_update_led_color();
-			// Blink LED.
-			LED_single_blink(2000, lvrm_ctx.led_color);
+#ifdef STORAGE_MODE
+			// Go back to storage mode when idle (wake-up is a reset).
+			if (LVRM_is_storage_allowed() != 0) {
+				STORAGE_enter(LVRM_STORAGE_WAKEUP_PERIOD_SECONDS);
+			}
+#endif
+			// Intermediate wake-ups of a long measurement period only reload the watchdog.
+			lvrm_ctx.wakeup_count++;
+			if ((lvrm_ctx.follow_up_count != 0) || (lvrm_ctx.wakeup_count >= lvrm_ctx.measurement_wakeups)) {
+				LVRM_perform_periodic_tasks();
+			}
 		}
+		// Process command.
+		lvrm_ctx.command_pending = AT_is_command_pending();
+#ifdef STORAGE_MODE
+		if (lvrm_ctx.command_pending != 0) {
+			lvrm_ctx.activity_timestamp_seconds = RTC_get_uptime_seconds();
+			lvrm_ctx.storage_idle_seconds = LVRM_STORAGE_IDLE_SECONDS;
+		}
+#endif
 		AT_task();
+		LVRM_check_relay_state();
+		// Merge a due-soon measurement into the command wake-up and slide the RTC deadline.
+		if ((lvrm_ctx.command_pending != 0) && ((int) (lvrm_ctx.next_measurement_seconds - RTC_get_uptime_seconds()) <= LVRM_COALESCING_TOLERANCE_SECONDS)) {
+			RTC_restart_wakeup_timer(LVRM_get_wakeup_period());
+			LVRM_perform_periodic_tasks();
+		}
+		LED_task();
 	}
 }
@@ -12,7 +12,14 @@
 #include "lptim.h"
 #include "mapping.h"
 #include "math.h"
+#include "mode.h"
 #include "rcc_reg.h"
+#include "rtc.h"
+#ifdef ADC_STREAM
+#include "cic.h"
+#include "goertzel.h"
+#include "tim.h"
+#endif
 
 /*** ADC local macros ***/
 
@@ -28,6 +35,7 @@
 
 #define ADC_VREFINT_VOLTAGE_MV				((VREFINT_CAL * VREFINT_VCC_CALIB_MV) / (ADC_FULL_SCALE_12BITS))
 #define ADC_VMCU_DEFAULT_MV					3000
+#define ADC_VREFINT_PLAUSIBILITY_RATIO		32 // Refresh VREFINT if input voltage raw result moved by more than 1/32 (3%).
 
 #define ADC_VOLTAGE_DIVIDER_RATIO_VIN		10
 #define ADC_VOLTAGE_DIVIDER_RATIO_VOUT		10
@@ -36,21 +44,69 @@
 #define ADC_LT6106_SHUNT_RESISTOR_MOHMS		10
 #define ADC_LT6106_OFFSET_CURRENT_UA		25000 // 250µV maximum / 10mR = 25mA.
 
+#ifdef ADC_STREAM
+#define ADC_CIC_FRACTIONAL_BITS				4 // Decimated results are converted on 16 bits.
+#define ADC_RIPPLE_NUMBER_OF_SAMPLES		256 // 64ms burst, 15.6Hz bin width.
+#define ADC_RIPPLE_FRACTIONAL_BITS			4
+#endif
+
 #define ADC_TIMEOUT_COUNT					1000000
 
+// Compiler barrier used by the sequence lock.
+#define ADC_MEMORY_BARRIER()				__asm volatile ("" ::: "memory")
+
 /*** ADC local structures ***/
 
 typedef struct {
 	unsigned int vrefint_12bits;
-	unsigned int data[ADC_DATA_IDX_MAX];
+	unsigned int data_12bits[ADC_DATA_IDX_VMCU_MV];
+	unsigned int data_vrefint_12bits[ADC_DATA_IDX_VMCU_MV]; // Reference result used for each input.
+} ADC_raw_t;
+
+typedef struct {
+	unsigned char vrefint_refreshed;
+	unsigned int vin_12bits_reference;
+	ADC_raw_t raw;
+	unsigned int timestamp_seconds;
+	volatile unsigned int sequence; // Odd while raw results are being updated.
+	unsigned int data[ADC_DATA_IDX_MAX]; // Converted data, valid until the next acquisition.
+	unsigned char data_valid_mask;
 } ADC_context_t;
 
 /*** ADC local global variables ***/
 
 static ADC_context_t adc_ctx;
+static const unsigned char ADC_DATA_CHANNEL[ADC_DATA_IDX_VMCU_MV] = {ADC_CHANNEL_VIN, ADC_CHANNEL_VOUT, ADC_CHANNEL_IOUT};
 
 /*** ADC local functions ***/
 
+/* SWITCH ADC ON.
+ * @param:	None.
+ * @return:	1 if the ADC is ready, 0 otherwise (timeout).
+ */
+static unsigned char ADC1_power_on(void) {
+	// Enable ADC peripheral.
+	ADC1 -> CR |= (0b1 << 0); // ADEN='1'.
+	unsigned int loop_count = 0;
+	while (((ADC1 -> ISR) & (0b1 << 0)) == 0) {
+		// Wait for ADC to be ready (ADRDY='1') or timeout.
+		loop_count++;
+		if (loop_count > ADC_TIMEOUT_COUNT) return 0;
+	}
+	return 1;
+}
+
+/* SWITCH ADC OFF.
+ * @param:	None.
+ * @return:	None.
+ */
+static void ADC1_power_off(void) {
+	// Disable ADC peripheral.
+	if (((ADC1 -> CR) & (0b1 << 0)) != 0) {
+		ADC1 -> CR |= (0b1 << 1); // ADDIS='1'.
+	}
+}
+
 /* PERFORM A SINGLE ADC CONVERSION.
  * @param adc_channel:			Channel to convert.
  * @param adc_result_12bits:	Pointer to int that will contain ADC raw result on 12 bits.
@@ -89,62 +145,158 @@ static void ADC1_filtered_conversion(unsigned char adc_channel, unsigned int* ad
 	(*adc_result_12bits) = MATH_median_filter(adc_sample_buf, ADC_MEDIAN_FILTER_LENGTH, ADC_CENTER_AVERAGE_LENGTH);
 }
 
-/* COMPUTE INPUT VOLTAGE.
- * @param:	None.
- * @return:	None.
+#ifdef ADC_STREAM
+/* START HARDWARE TIMED CONVERSIONS.
+ * @param adc_channel:	Channel to convert.
+ * @return:				None.
  */
-static void ADC1_compute_vin(void) {
-	// Get raw result.
-	unsigned int vin_12bits = 0;
-	ADC1_filtered_conversion(ADC_CHANNEL_VIN, &vin_12bits);
-	// Convert to mV using bandgap result.
-	adc_ctx.data[ADC_DATA_IDX_VIN_MV] = (ADC_VREFINT_VOLTAGE_MV * vin_12bits * ADC_VOLTAGE_DIVIDER_RATIO_VIN) / (adc_ctx.vrefint_12bits);
+static void ADC1_start_stream(unsigned char adc_channel) {
+	// Select input channel.
+	ADC1 -> CHSELR &= 0xFFF80000; // Reset all bits.
+	ADC1 -> CHSELR |= (0b1 << adc_channel);
+	// Clear all flags.
+	ADC1 -> ISR |= 0x0000089F;
+	// Trigger conversions on TIM2 update event.
+	ADC1 -> CFGR1 &= ~((0b11 << 10) | (0b111 << 6));
+	ADC1 -> CFGR1 |= (0b01 << 10) | (0b010 << 6); // EXTEN='01' and EXTSEL='010' (TIM2_TRGO).
+	ADC1 -> CR |= (0b1 << 2); // ADSTART='1'.
+	TIM2_start_trigger(ADC_STREAM_SAMPLING_FREQUENCY_HZ);
 }
 
-/* COMPUTE OUTPUT VOLTAGE.
- * @param:	None.
- * @return:	None.
+/* WAIT FOR THE NEXT HARDWARE TIMED CONVERSION.
+ * @param adc_result_12bits:	Pointer to int that will contain ADC raw result on 12 bits.
+ * @return:						1 if a sample was read, 0 otherwise (timeout or overrun).
  */
-static void ADC1_compute_vout(void) {
-	// Get raw result.
-	unsigned int vout_12bits = 0;
-	ADC1_filtered_conversion(ADC_CHANNEL_VOUT, &vout_12bits);
-	// Convert to mV using bandgap result.
-	adc_ctx.data[ADC_DATA_IDX_VOUT_MV] = (ADC_VREFINT_VOLTAGE_MV * vout_12bits * ADC_VOLTAGE_DIVIDER_RATIO_VOUT) / (adc_ctx.vrefint_12bits);
+static unsigned char ADC1_read_stream(unsigned int* adc_result_12bits) {
+	unsigned int loop_count = 0;
+	while (((ADC1 -> ISR) & (0b1 << 2)) == 0) {
+		// Wait end of conversion ('EOC='1') or timeout.
+		loop_count++;
+		if (loop_count > ADC_TIMEOUT_COUNT) return 0;
+	}
+	// A missed conversion would silently skew the stream processing.
+	if (((ADC1 -> ISR) & (0b1 << 4)) != 0) {
+		ADC1 -> ISR |= (0b1 << 4); // Clear OVR flag.
+		return 0;
+	}
+	// Reading data clears EOC flag.
+	(*adc_result_12bits) = (ADC1 -> DR);
+	return 1;
 }
 
-/* COMPUTE OUTPUT CURRENT.
+/* STOP HARDWARE TIMED CONVERSIONS.
  * @param:	None.
  * @return:	None.
  */
-static void ADC1_compute_iout(void) {
-	// Get raw result.
-	unsigned int iout_12bits = 0;
-	ADC1_filtered_conversion(ADC_CHANNEL_IOUT, &iout_12bits);
-	// Convert to uA using bandgap result.
-	unsigned long long num = iout_12bits;
+static void ADC1_stop_stream(void) {
+	// Stop trigger source.
+	TIM2_stop_trigger();
+	// Stop ADC.
+	if (((ADC1 -> CR) & (0b1 << 2)) != 0) {
+		ADC1 -> CR |= (0b1 << 4); // ADSTP='1'.
+		unsigned int loop_count = 0;
+		while (((ADC1 -> CR) & (0b1 << 4)) != 0) {
+			// Wait for ADC to be stopped or timeout.
+			loop_count++;
+			if (loop_count > ADC_TIMEOUT_COUNT) break;
+		}
+	}
+	// Go back to software trigger.
+	ADC1 -> CFGR1 &= ~((0b11 << 10) | (0b111 << 6));
+}
+#endif
+
+/* CONVERT A RAW RESULT TO PHYSICAL UNIT.
+ * @param data_idx:			Index of the data (VMCU excluded).
+ * @param raw_result:		Raw result with 12 integer bits.
+ * @param vrefint_12bits:	Internal reference raw result to use.
+ * @param fractional_bits:	Number of fractional bits of the raw result.
+ * @param remove_offset:	Remove sensor offset if non zero (absolute value), keep it for amplitudes.
+ * @return:					Data in mV or uA.
+ */
+static unsigned int ADC1_convert(ADC_data_index_t data_idx, unsigned int raw_result, unsigned int vrefint_12bits, unsigned char fractional_bits, unsigned char remove_offset) {
+	// Local variables.
+	unsigned long long num = raw_result;
+	unsigned long long den = (((unsigned long long) vrefint_12bits) << fractional_bits);
+	unsigned int data = 0;
+	// Convert using bandgap result.
 	num *= ADC_VREFINT_VOLTAGE_MV;
-	num *= 1000000;
-	unsigned long long den = adc_ctx.vrefint_12bits;
-	den *= ADC_LT6106_VOLTAGE_GAIN;
-	den *= ADC_LT6106_SHUNT_RESISTOR_MOHMS;
-	adc_ctx.data[ADC_DATA_IDX_IOUT_UA] = (num) / (den);
+	switch (data_idx) {
+	case ADC_DATA_IDX_VIN_MV:
+		num *= ADC_VOLTAGE_DIVIDER_RATIO_VIN;
+		break;
+	case ADC_DATA_IDX_VOUT_MV:
+		num *= ADC_VOLTAGE_DIVIDER_RATIO_VOUT;
+		break;
+	case ADC_DATA_IDX_IOUT_UA:
+		num *= 1000000;
+		den *= ADC_LT6106_VOLTAGE_GAIN;
+		den *= ADC_LT6106_SHUNT_RESISTOR_MOHMS;
+		break;
+	default:
+		return 0;
+	}
+	if (den == 0) return 0;
+	data = (num) / (den);
 	// Remove offset current.
-	if (adc_ctx.data[ADC_DATA_IDX_IOUT_UA] < ADC_LT6106_OFFSET_CURRENT_UA) {
-		adc_ctx.data[ADC_DATA_IDX_IOUT_UA] = 0;
+	if ((data_idx == ADC_DATA_IDX_IOUT_UA) && (remove_offset != 0)) {
+		data = (data < ADC_LT6106_OFFSET_CURRENT_UA) ? 0 : (data - ADC_LT6106_OFFSET_CURRENT_UA);
 	}
-	else {
-		adc_ctx.data[ADC_DATA_IDX_IOUT_UA] -= ADC_LT6106_OFFSET_CURRENT_UA;
+	return data;
+}
+
+/* COMPUTE A DATA FROM RAW RESULTS.
+ * @param raw:		Raw results to use.
+ * @param data_idx:	Index of the data to compute.
+ * @return:			Data in physical unit.
+ */
+static unsigned int ADC1_compute(ADC_raw_t* raw, ADC_data_index_t data_idx) {
+	// Local variables.
+	unsigned long long pout_nw = 0;
+	unsigned int data = 0;
+	switch (data_idx) {
+	case ADC_DATA_IDX_VMCU_MV:
+		// Retrieve supply voltage from bandgap result.
+		data = ((raw -> vrefint_12bits) == 0) ? ADC_VMCU_DEFAULT_MV : ((VREFINT_CAL * VREFINT_VCC_CALIB_MV) / (raw -> vrefint_12bits));
+		break;
+	case ADC_DATA_IDX_POUT_MW:
+		// mV * uA = nW.
+		pout_nw = ((unsigned long long) ADC1_compute(raw, ADC_DATA_IDX_VOUT_MV)) * ADC1_compute(raw, ADC_DATA_IDX_IOUT_UA);
+		data = (unsigned int) (pout_nw / 1000000);
+		break;
+	default:
+		data = ADC1_convert(data_idx, (raw -> data_12bits)[data_idx], (raw -> data_vrefint_12bits)[data_idx], 0, 1);
+		break;
 	}
+	return data;
 }
 
-/* COMPUTE MCU SUPPLY VOLTAGE.
+/* MEASURE INTERNAL VOLTAGE REFERENCE.
  * @param:	None.
  * @return:	None.
  */
-static void ADC1_compute_vmcu(void) {
-	// Retrieve supply voltage from bandgap result.
-	adc_ctx.data[ADC_DATA_IDX_VMCU_MV] = (VREFINT_CAL * VREFINT_VCC_CALIB_MV) / (adc_ctx.vrefint_12bits);
+static void ADC1_update_vrefint(void) {
+	// Wake-up VREFINT.
+	ADC1 -> CCR |= (0b1 << 22); //  VREFEF='1'.
+	LPTIM1_delay_milliseconds(10); // Wait internal reference stabilization (max 3ms).
+	ADC1_filtered_conversion(ADC_CHANNEL_VREFINT, &adc_ctx.raw.vrefint_12bits);
+	// Turn VREFINT off.
+	ADC1 -> CCR &= ~(0b1 << 22); // VREFEF='0'.
+	adc_ctx.vrefint_refreshed = 1;
+	// MCU voltage must be converted again.
+	adc_ctx.data_valid_mask = 0;
+}
+
+/* CHECK IF THE CACHED VREFINT RESULT IS STILL PLAUSIBLE.
+ * @param vin_12bits:	Current input voltage raw result.
+ * @return:				1 if the input voltage raw result did not move since last reference update, 0 otherwise.
+ */
+static unsigned char ADC1_is_vrefint_plausible(unsigned int vin_12bits) {
+	// Local variables.
+	unsigned int vin_12bits_delta = 0;
+	// A supply change scales all raw results, including the slowly varying input voltage.
+	vin_12bits_delta = (vin_12bits > adc_ctx.vin_12bits_reference) ? (vin_12bits - adc_ctx.vin_12bits_reference) : (adc_ctx.vin_12bits_reference - vin_12bits);
+	return ((vin_12bits_delta * ADC_VREFINT_PLAUSIBILITY_RATIO) <= adc_ctx.vin_12bits_reference);
 }
 
 /*** ADC functions ***/
@@ -159,10 +311,17 @@ void ADC1_init(void) {
 	GPIO_configure(&GPIO_ADC1_IN4, GPIO_MODE_ANALOG, GPIO_TYPE_OPEN_DRAIN, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	GPIO_configure(&GPIO_ADC1_IN6, GPIO_MODE_ANALOG, GPIO_TYPE_OPEN_DRAIN, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	// Init context.
-	adc_ctx.vrefint_12bits = 0;
+	adc_ctx.raw.vrefint_12bits = 0;
+	adc_ctx.vrefint_refreshed = 0;
+	adc_ctx.vin_12bits_reference = 0;
+	adc_ctx.timestamp_seconds = 0;
+	adc_ctx.sequence = 0;
+	adc_ctx.data_valid_mask = 0;
 	unsigned char data_idx = 0;
-	for (data_idx=0 ; data_idx<ADC_DATA_IDX_MAX ; data_idx++) adc_ctx.data[data_idx] = 0;
-	adc_ctx.data[ADC_DATA_IDX_VMCU_MV] = ADC_VMCU_DEFAULT_MV;
+	for (data_idx=0 ; data_idx<ADC_DATA_IDX_VMCU_MV ; data_idx++) {
+		adc_ctx.raw.data_12bits[data_idx] = 0;
+		adc_ctx.raw.data_vrefint_12bits[data_idx] = 0;
+	}
 	// Enable peripheral clock.
 	RCC -> APB2ENR |= (0b1 << 9); // ADCEN='1'.
 	// Ensure ADC is disabled.
@@ -207,40 +366,222 @@ void ADC1_disable(void) {
 }
 
 /* PERFORM INTERNAL ADC MEASUREMENTS.
- * @param:	None.
- * @return:	None.
+ * @param data_mask:	Bit mask of the data to update (bit i for data index i), other data keep their last value.
+ * 						VREFINT is only measured when VMCU is requested or when the cached result is not plausible anymore.
+ * 						Plausibility is checked against the input voltage, which is converted on every acquisition.
+ * @return:				None.
+ * Only raw results are stored, conversion is performed by ADC1_get_data() when a data is read.
  */
-void ADC1_perform_measurements(void) {
+void ADC1_perform_measurements(unsigned char data_mask) {
+	// Local variables.
+	unsigned char data_idx = 0;
+	unsigned int vin_12bits = 0;
+	// Nothing to do if no data is due.
+	if ((data_mask & ADC_DATA_MASK_ALL) == 0) return;
 	// Enable ADC peripheral.
-	ADC1 -> CR |= (0b1 << 0); // ADEN='1'.
-	unsigned int loop_count = 0;
-	while (((ADC1 -> ISR) & (0b1 << 0)) == 0) {
-		// Wait for ADC to be ready (ADRDY='1') or timeout.
-		loop_count++;
-		if (loop_count > ADC_TIMEOUT_COUNT) return;
+	if (ADC1_power_on() == 0) return;
+	// Raw results are updated in place.
+	adc_ctx.sequence++;
+	ADC_MEMORY_BARRIER();
+	// Refresh reference when MCU voltage is due or when it was never measured.
+	adc_ctx.vrefint_refreshed = 0;
+	if (((data_mask & (0b1 << ADC_DATA_IDX_VMCU_MV)) != 0) || (adc_ctx.raw.vrefint_12bits == 0)) {
+		ADC1_update_vrefint();
 	}
-	// Wake-up VREFINT.
-	ADC1 -> CCR |= (0b1 << 22); //  VREFEF='1'.
-	LPTIM1_delay_milliseconds(10); // Wait internal reference stabilization (max 3ms).
-	// Perform measurements.
-	ADC1_filtered_conversion(ADC_CHANNEL_VREFINT, &adc_ctx.vrefint_12bits);
-	ADC1_compute_vin();
-	ADC1_compute_vout();
-	ADC1_compute_iout();
-	ADC1_compute_vmcu();
-	// Turn VREFINT off.
-	ADC1 -> CCR &= ~(0b1 << 22); // VREFEF='0'.
+	// Perform raw measurements.
+	if ((data_mask & (0b1 << ADC_DATA_IDX_VIN_MV)) != 0) {
+		ADC1_filtered_conversion(ADC_CHANNEL_VIN, &(adc_ctx.raw.data_12bits[ADC_DATA_IDX_VIN_MV]));
+		vin_12bits = adc_ctx.raw.data_12bits[ADC_DATA_IDX_VIN_MV];
+	}
+	else {
+		// Single conversion is enough for the plausibility check.
+		ADC1_single_conversion(ADC_CHANNEL_VIN, &vin_12bits);
+	}
+	// Check cached reference on every acquisition.
+	if ((adc_ctx.vrefint_refreshed == 0) && (ADC1_is_vrefint_plausible(vin_12bits) == 0)) {
+		ADC1_update_vrefint();
+	}
+	if (adc_ctx.vrefint_refreshed != 0) {
+		adc_ctx.vin_12bits_reference = vin_12bits;
+	}
+	if ((data_mask & (0b1 << ADC_DATA_IDX_VOUT_MV)) != 0) {
+		ADC1_filtered_conversion(ADC_CHANNEL_VOUT, &(adc_ctx.raw.data_12bits[ADC_DATA_IDX_VOUT_MV]));
+	}
+	if ((data_mask & (0b1 << ADC_DATA_IDX_IOUT_UA)) != 0) {
+		ADC1_filtered_conversion(ADC_CHANNEL_IOUT, &(adc_ctx.raw.data_12bits[ADC_DATA_IDX_IOUT_UA]));
+	}
+	// Bind each new result to the current reference and invalidate converted data.
+	for (data_idx=0 ; data_idx<ADC_DATA_IDX_VMCU_MV ; data_idx++) {
+		if ((data_mask & (0b1 << data_idx)) != 0) {
+			adc_ctx.raw.data_vrefint_12bits[data_idx] = adc_ctx.raw.vrefint_12bits;
+		}
+	}
+	adc_ctx.data_valid_mask = 0;
+	adc_ctx.timestamp_seconds = RTC_get_uptime_seconds();
+	ADC_MEMORY_BARRIER();
+	adc_ctx.sequence++;
 	// Disable ADC peripheral.
-	if (((ADC1 -> CR) & (0b1 << 0)) != 0) {
-		ADC1 -> CR |= (0b1 << 1); // ADDIS='1'.
+	ADC1_power_off();
+}
+
+#ifdef ADC_STREAM
+/* PERFORM A HIGH RESOLUTION MEASUREMENT WITH A CIC DECIMATION FILTER.
+ * @param data_idx:			Index of the data to measure (VMCU excluded).
+ * @param cic_order:		Number of CIC filter stages.
+ * @param cic_ratio_log2:	Decimation ratio expressed as a power of 2 (order * ratio limited to ADC_STREAM_LENGTH_MAX_SAMPLES).
+ * @param data:				Pointer that will contain the decimated data in mV or uA.
+ * @return:					1 if the measurement succeeded, 0 otherwise.
+ */
+unsigned char ADC1_perform_decimated_measurement(ADC_data_index_t data_idx, unsigned char cic_order, unsigned char cic_ratio_log2, unsigned int* data) {
+	// Local variables.
+	unsigned char status = 0;
+	CIC_context_t cic_ctx;
+	unsigned char number_of_outputs = 0;
+	unsigned char gain_bits = 0;
+	unsigned int sample_12bits = 0;
+	unsigned int cic_output = 0;
+	// Check parameters.
+	if (data_idx >= ADC_DATA_IDX_VMCU_MV) return 0;
+	CIC_init(&cic_ctx, cic_order, cic_ratio_log2);
+	if (((unsigned int) cic_ctx.order << cic_ctx.ratio_log2) > ADC_STREAM_LENGTH_MAX_SAMPLES) return 0;
+	// Enable ADC peripheral.
+	if (ADC1_power_on() == 0) goto errors;
+	if (adc_ctx.raw.vrefint_12bits == 0) {
+		ADC1_update_vrefint();
 	}
+	// Feed filter with samples as they arrive.
+	ADC1_start_stream(ADC_DATA_CHANNEL[data_idx]);
+	while (number_of_outputs < cic_ctx.order) {
+		if (ADC1_read_stream(&sample_12bits) == 0) break;
+		// The first (order-1) outputs are part of the filter transient.
+		number_of_outputs += CIC_process(&cic_ctx, sample_12bits, &cic_output);
+	}
+	ADC1_stop_stream();
+	if (number_of_outputs < cic_ctx.order) goto errors;
+	// Scale output to the fixed number of fractional bits.
+	gain_bits = CIC_get_gain_bits(&cic_ctx);
+	if (gain_bits >= ADC_CIC_FRACTIONAL_BITS) {
+		cic_output >>= (gain_bits - ADC_CIC_FRACTIONAL_BITS);
+	}
+	else {
+		cic_output <<= (ADC_CIC_FRACTIONAL_BITS - gain_bits);
+	}
+	(*data) = ADC1_convert(data_idx, cic_output, adc_ctx.raw.vrefint_12bits, ADC_CIC_FRACTIONAL_BITS, 1);
+	status = 1;
+errors:
+	ADC1_power_off();
+	return status;
 }
 
+/* MEASURE RIPPLE AMPLITUDE AT SEVERAL FREQUENCIES WITH GOERTZEL DETECTORS.
+ * @param data_idx:					Index of the data to analyze (VMCU excluded).
+ * @param frequencies_hz:			Frequencies to analyze (must be lower than half the sampling frequency).
+ * @param number_of_frequencies:	Number of frequencies (up to ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX).
+ * @param amplitudes:				Array that will contain the peak amplitude of each frequency in mV or uA.
+ * @return:							1 if the analysis succeeded, 0 otherwise.
+ */
+unsigned char ADC1_perform_ripple_analysis(ADC_data_index_t data_idx, unsigned int* frequencies_hz, unsigned char number_of_frequencies, unsigned int* amplitudes) {
+	// Local variables.
+	unsigned char status = 0;
+	GOERTZEL_context_t goertzel_ctx[ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX];
+	unsigned char idx = 0;
+	unsigned short sample_idx = 0;
+	unsigned int sample_12bits = 0;
+	int dc_offset_12bits = 0;
+	unsigned int amplitude = 0;
+	// Check parameters.
+	if ((data_idx >= ADC_DATA_IDX_VMCU_MV) || (number_of_frequencies > ADC_RIPPLE_NUMBER_OF_FREQUENCIES_MAX)) return 0;
+	for (idx=0 ; idx<number_of_frequencies ; idx++) {
+		if ((2 * frequencies_hz[idx]) >= ADC_STREAM_SAMPLING_FREQUENCY_HZ) return 0;
+		GOERTZEL_init(&(goertzel_ctx[idx]), frequencies_hz[idx], ADC_STREAM_SAMPLING_FREQUENCY_HZ);
+	}
+	// Enable ADC peripheral.
+	if (ADC1_power_on() == 0) goto errors;
+	if (adc_ctx.raw.vrefint_12bits == 0) {
+		ADC1_update_vrefint();
+	}
+	// Run all detectors on the burst without storing samples.
+	ADC1_start_stream(ADC_DATA_CHANNEL[data_idx]);
+	for (sample_idx=0 ; sample_idx<ADC_RIPPLE_NUMBER_OF_SAMPLES ; sample_idx++) {
+		if (ADC1_read_stream(&sample_12bits) == 0) break;
+		// First sample is used as DC estimate to limit detectors dynamic.
+		if (sample_idx == 0) {
+			dc_offset_12bits = (int) sample_12bits;
+		}
+		for (idx=0 ; idx<number_of_frequencies ; idx++) {
+			GOERTZEL_process(&(goertzel_ctx[idx]), ((int) sample_12bits) - dc_offset_12bits);
+		}
+	}
+	ADC1_stop_stream();
+	if (sample_idx < ADC_RIPPLE_NUMBER_OF_SAMPLES) goto errors;
+	// Peak amplitude is 2 * magnitude / N.
+	for (idx=0 ; idx<number_of_frequencies ; idx++) {
+		amplitude = (GOERTZEL_get_magnitude(&(goertzel_ctx[idx])) << (1 + ADC_RIPPLE_FRACTIONAL_BITS)) / (ADC_RIPPLE_NUMBER_OF_SAMPLES);
+		amplitudes[idx] = ADC1_convert(data_idx, amplitude, adc_ctx.raw.vrefint_12bits, ADC_RIPPLE_FRACTIONAL_BITS, 0);
+	}
+	status = 1;
+errors:
+	ADC1_power_off();
+	return status;
+}
+#endif
+
 /* GET ADC DATA.
  * @param data_idx:		Index of the data to retrieve.
  * @param data:				Pointer that will contain ADC data.
  * @return:					None.
  */
 void ADC1_get_data(ADC_data_index_t data_idx, unsigned int* data) {
+	// Check parameter.
+	if (data_idx >= ADC_DATA_IDX_MAX) {
+		(*data) = 0;
+		return;
+	}
+	// Convert on first read after acquisition.
+	if ((adc_ctx.data_valid_mask & (0b1 << data_idx)) == 0) {
+		adc_ctx.data[data_idx] = ADC1_compute(&adc_ctx.raw, data_idx);
+		adc_ctx.data_valid_mask |= (0b1 << data_idx);
+	}
 	(*data) = adc_ctx.data[data_idx];
 }
+
+/* GET TIMESTAMP OF THE LAST ACQUISITION.
+ * @param:	None.
+ * @return:	RTC uptime in seconds at the end of the last ADC1_perform_measurements() call.
+ */
+unsigned int ADC1_get_timestamp_seconds(void) {
+	return adc_ctx.timestamp_seconds;
+}
+
+/* GET SEQUENCE NUMBER OF THE LAST ACQUISITION.
+ * @param:	None.
+ * @return:	Sequence number, which changes on each ADC1_perform_measurements() call.
+ */
+unsigned int ADC1_get_sequence(void) {
+	return adc_ctx.sequence;
+}
+
+/* GET ALL ADC DATA OF THE LAST ACQUISITION WITHOUT DISABLING INTERRUPTS.
+ * @param snapshot:	Pointer that will contain a consistent copy of the data and its timestamp.
+ * @return:			None.
+ * Warning: this function must not be called from a context which can preempt ADC1_perform_measurements().
+ */
+void ADC1_get_snapshot(ADC_snapshot_t* snapshot) {
+	// Local variables.
+	unsigned int sequence = 0;
+	unsigned char data_idx = 0;
+	ADC_raw_t raw;
+	// Copy raw results until no update occurred meanwhile.
+	do {
+		sequence = adc_ctx.sequence;
+		ADC_MEMORY_BARRIER();
+		raw = adc_ctx.raw;
+		(snapshot -> timestamp_seconds) = adc_ctx.timestamp_seconds;
+		ADC_MEMORY_BARRIER();
+	}
+	while (((sequence & 0b1) != 0) || (sequence != adc_ctx.sequence));
+	// Convert outside of the critical section.
+	for (data_idx=0 ; data_idx<ADC_DATA_IDX_MAX ; data_idx++) {
+		(snapshot -> data)[data_idx] = ADC1_compute(&raw, data_idx);
+	}
+}
@@ -40,11 +40,3 @@ void __attribute__((optimize("-O0"))) SVC_Handler(void) {
 void __attribute__((optimize("-O0"))) PendSV_Handler(void) {
 	// TBD.
 }
-
-/* SYSTEM TICK INTERRUPT HANDLER.
- * @param:	None.
- * @return:	None.
- */
-void __attribute__((optimize("-O0"))) SysTick_Handler(void) {
-	// TBD.
-}
@@ -32,6 +32,7 @@ static volatile unsigned char lptim_wake_up = 0;
  * @return:	None.
  */
 void __attribute__((optimize("-O0"))) LPTIM1_IRQHandler(void) {
+	NVIC_STATS_ENTER(NVIC_IT_LPTIM1);
 	// Check flag.
 	if (((LPTIM1 -> ISR) & (0b1 << 1)) != 0) {
 		// Set local flag.
@@ -41,6 +42,7 @@ void __attribute__((optimize("-O0"))) LPTIM1_IRQHandler(void) {
 		// Clear flag.
 		LPTIM1 -> ICR |= (0b1 << 1);
 	}
+	NVIC_STATS_EXIT(NVIC_IT_LPTIM1);
 }
 
 /* WRITE ARR REGISTER.
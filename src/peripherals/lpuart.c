@@ -10,6 +10,7 @@
 #include "at.h"
 #include "exti.h"
 #include "gpio.h"
+#include "lptim.h"
 #include "lpuart_reg.h"
 #include "mapping.h"
 #include "nvic.h"
@@ -24,17 +25,90 @@
 #define LPUART_ADDR_LENGTH_BYTES	1
 #define LPUART_ADDR_NODE			0x31
 #define LPUART_ADDR_MASTER			0x65
+#define LPUART_NODE_PRIORITY		(LPUART_ADDR_NODE & 0x7F) // Lowest address gets the bus first.
+#else
+#define LPUART_NODE_PRIORITY		0
+#endif
+#ifdef ALARM_PUSH
+// Arbitrated transmission (1 byte lasts 1.04ms at 9600 bauds).
+#define LPUART_BACKOFF_MIN_MS		3
+#define LPUART_BACKOFF_SLOT_MS		2
+#endif
+
+/*** LPUART local structures ***/
+
+#ifdef RAM_VECTORS
+typedef struct {
+	LPUART_rx_mode_t rx_mode;
+#ifdef RSM
+	volatile unsigned char addr_count;
+#endif
+} LPUART_context_t;
 #endif
 
 /*** LPUART local global variables ***/
 
+#ifdef RAM_VECTORS
+static LPUART_context_t lpuart_ctx;
+#else
 #ifdef RSM
 static volatile unsigned int lpuart_irq_count = 0;
 #endif
+#endif
 
 /*** LPUART local functions ***/
 
+#ifdef RAM_VECTORS
+/* LPUART1 INTERRUPT HANDLER FOR AT COMMAND PAYLOAD.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPUART1_rx_at_handler(void) {
+	NVIC_STATS_ENTER(NVIC_IT_LPUART1);
+	// RXNE is always set here (ORE keeps the previous byte), reading RDR clears it.
+	AT_fill_rx_buffer(LPUART1 -> RDR);
+	// Clear ORE flag.
+	LPUART1 -> ICR |= (0b1 << 3);
+	NVIC_STATS_EXIT(NVIC_IT_LPUART1);
+}
+
+// Payload handler of each receive mode.
+static const NVIC_handler_t LPUART_RX_HANDLER[LPUART_RX_MODE_LAST] = {LPUART1_rx_at_handler};
+
+#ifdef RSM
+/* LPUART1 INTERRUPT HANDLER FOR ADDRESS BYTES.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPUART1_rx_address_handler(void) {
+	NVIC_STATS_ENTER(NVIC_IT_LPUART1);
+	// Discard address byte.
+	LPUART1 -> RQR |= (0b1 << 3); // RXFRQ='1'.
+	LPUART1 -> ICR |= (0b1 << 3);
+	// Switch to payload handler once address is received.
+	lpuart_ctx.addr_count++;
+	if (lpuart_ctx.addr_count >= LPUART_ADDR_LENGTH_BYTES) {
+		NVIC_set_handler(NVIC_IT_LPUART1, LPUART_RX_HANDLER[lpuart_ctx.rx_mode]);
+	}
+	NVIC_STATS_EXIT(NVIC_IT_LPUART1);
+}
+#endif
+
+/* INSTALL FIRST HANDLER OF A RECEIVED FRAME.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPUART1_install_rx_handler(void) {
+#ifdef RSM
+	lpuart_ctx.addr_count = 0;
+	NVIC_set_handler(NVIC_IT_LPUART1, LPUART1_rx_address_handler);
+#else
+	NVIC_set_handler(NVIC_IT_LPUART1, LPUART_RX_HANDLER[lpuart_ctx.rx_mode]);
+#endif
+}
+#else
 void LPUART1_IRQHandler(void) {
+	NVIC_STATS_ENTER(NVIC_IT_LPUART1);
 	// RXNE interrupt.
 	if (((LPUART1 -> ISR) & (0b1 << 5)) != 0) {
 #ifdef RSM
@@ -57,7 +131,9 @@ void LPUART1_IRQHandler(void) {
 		// Clear ORE flag.
 		LPUART1 -> ICR |= (0b1 << 3);
 	}
+	NVIC_STATS_EXIT(NVIC_IT_LPUART1);
 }
+#endif
 
 /* FILL LPUART1 TX BUFFER WITH A NEW BYTE.
  * @param tx_byte:	Byte to append.
@@ -75,6 +151,33 @@ static void LPUART1_fill_tx_buffer(unsigned char tx_byte) {
 	}
 }
 
+#ifdef ALARM_PUSH
+/* SEND A BYTE THROUGH LPUART1 AND CHECK IT IS READ BACK UNCHANGED.
+ * @param tx_byte:	Byte to send.
+ * @return:			1 if the byte was read back unchanged, 0 otherwise (collision).
+ */
+static unsigned char LPUART1_send_byte_checked(unsigned char tx_byte) {
+	// Local variables.
+	unsigned int loop_count = 0;
+	unsigned char rx_byte = 0;
+	// Fill transmit register.
+	LPUART1 -> TDR = tx_byte;
+	// Wait for own byte on the bus.
+	while (((LPUART1 -> ISR) & (0b1 << 5)) == 0) {
+		// Wait for RXNE='1' or timeout.
+		loop_count++;
+		if (loop_count > LPUART_TIMEOUT_COUNT) return 0;
+	}
+	rx_byte = (LPUART1 -> RDR) & 0xFF;
+	// Another driver corrupts the echo or its framing.
+	if (((LPUART1 -> ISR) & (0b111 << 1)) != 0) {
+		LPUART1 -> ICR |= (0b111 << 1); // Clear FE, NF and ORE flags.
+		return 0;
+	}
+	return (rx_byte == tx_byte);
+}
+#endif
+
 /*** LPUART functions ***/
 
 /* CONFIGURE LPUART1.
@@ -82,6 +185,10 @@ static void LPUART1_fill_tx_buffer(unsigned char tx_byte) {
  * @return:	None.
  */
 void LPUART1_init(void) {
+#ifdef RAM_VECTORS
+	// Init context.
+	lpuart_ctx.rx_mode = LPUART_RX_MODE_AT;
+#endif
 	// Select LSE as clock source.
 	RCC -> CCIPR |= (0b11 << 10); // LPUART1SEL='11'.
 	// Enable peripheral clock.
@@ -124,6 +231,9 @@ void LPUART1_enable_rx(void) {
 #endif
 	// Clear flag and enable interrupt.
 	LPUART1 -> RQR |= (0b1 << 3);
+#ifdef RAM_VECTORS
+	LPUART1_install_rx_handler();
+#endif
 	NVIC_enable_interrupt(NVIC_IT_LPUART1);
 	// Enable receiver.
 	LPUART1 -> CR1 |= (0b1 << 2); // RE='1'.
@@ -136,7 +246,7 @@ void LPUART1_enable_rx(void) {
  * @return:	None.
  */
 void LPUART1_disable_rx(void) {
-#ifdef RSM
+#if (defined RSM) && !(defined RAM_VECTORS)
 	// Reset IRQ count for next command reception.
 	lpuart_irq_count = 0;
 #endif
@@ -165,3 +275,99 @@ void LPUART1_send_string(char* tx_string) {
 	// Wait for TC flag.
 	while (((LPUART1 -> ISR) & (0b1 << 6)) == 0);
 }
+
+/* SEND A BYTE ARRAY OF GIVEN LENGTH THROUGH LPUART1.
+ * @param tx_data:		Bytes to send.
+ * @param tx_length:	Number of bytes to send.
+ * @return:				None.
+ * Warning: in RSM mode, bytes with MSB set are address marks so payload must be ASCII.
+ */
+void LPUART1_send_bytes(unsigned char* tx_data, unsigned int tx_length) {
+	// Local variables.
+	unsigned int idx = 0;
+#ifdef RSM
+	// Send master address.
+	LPUART1_fill_tx_buffer(LPUART_ADDR_MASTER | 0x80);
+#endif
+	// Fill TX buffer with new bytes.
+	for (idx=0 ; idx<tx_length ; idx++) {
+		LPUART1_fill_tx_buffer(tx_data[idx]);
+	}
+	// Wait for TC flag.
+	while (((LPUART1 -> ISR) & (0b1 << 6)) == 0);
+}
+
+#ifdef RAM_VECTORS
+/* SELECT THE CONSUMER OF RECEIVED BYTES.
+ * @param rx_mode:	Receive mode (applied from the next received frame).
+ * @return:			None.
+ */
+void LPUART1_set_rx_mode(LPUART_rx_mode_t rx_mode) {
+	// Check parameter.
+	if (rx_mode >= LPUART_RX_MODE_LAST) return;
+	lpuart_ctx.rx_mode = rx_mode;
+}
+#endif
+
+/* GET NODE BUS ADDRESS.
+ * @param:	None.
+ * @return:	Node address (0 when address check is disabled).
+ */
+unsigned char LPUART1_get_node_address(void) {
+#ifdef RSM
+	return LPUART_ADDR_NODE;
+#else
+	return 0;
+#endif
+}
+
+#ifdef ALARM_PUSH
+/* SEND A BYTE ARRAY ON SHARED BUS WITH ADDRESS-DERIVED BACK-OFF AND COLLISION DETECTION.
+ * @param tx_data:		Bytes to send.
+ * @param tx_length:	Number of bytes to send.
+ * @return status:		1 if the bytes were sent without collision, 0 if the bus was busy or a collision occured.
+ */
+unsigned char LPUART1_send_bytes_arbitrated(unsigned char* tx_data, unsigned int tx_length) {
+	// Local variables.
+	unsigned char status = 0;
+	unsigned int backoff_ms = LPUART_BACKOFF_MIN_MS + (LPUART_NODE_PRIORITY * LPUART_BACKOFF_SLOT_MS);
+	unsigned int idx = 0;
+	unsigned int loop_count = 0;
+	// Listen to all bus traffic by polling.
+	NVIC_disable_interrupt(NVIC_IT_LPUART1);
+#ifdef RSM
+	LPUART1 -> CR1 &= ~(0b1 << 13); // MME='0'.
+#endif
+	LPUART1 -> RQR |= (0b1 << 3);
+	LPUART1 -> ICR |= (0b111 << 1);
+	LPUART1 -> CR1 |= (0b1 << 2); // RE='1'.
+	GPIO_configure(&GPIO_LPUART1_NRE, GPIO_MODE_ANALOG, GPIO_TYPE_OPEN_DRAIN, GPIO_SPEED_LOW, GPIO_PULL_NONE); // External pull-down resistor present.
+	// Bus must remain idle during the whole back-off.
+	for (idx=0 ; idx<backoff_ms ; idx++) {
+		LPTIM1_delay_milliseconds(1);
+		if (((LPUART1 -> ISR) & ((0b1 << 16) | (0b1 << 5))) != 0) goto errors; // BUSY or RXNE.
+	}
+#ifdef RSM
+	// Send master address.
+	if (LPUART1_send_byte_checked(LPUART_ADDR_MASTER | 0x80) == 0) goto errors;
+#endif
+	// Stop at first corrupted byte to release the bus.
+	for (idx=0 ; idx<tx_length ; idx++) {
+		if (LPUART1_send_byte_checked(tx_data[idx]) == 0) goto errors;
+	}
+	status = 1;
+errors:
+	// Wait for TC flag (driver enable is released by hardware).
+	while (((LPUART1 -> ISR) & (0b1 << 6)) == 0) {
+		loop_count++;
+		if (loop_count > LPUART_TIMEOUT_COUNT) break;
+	}
+	// Flush and go back to mute mode.
+#ifdef RSM
+	LPUART1 -> CR1 |= (0b1 << 13); // MME='1'.
+#endif
+	LPUART1 -> RQR |= (0b1 << 3);
+	LPUART1 -> ICR |= (0b111 << 1);
+	return status;
+}
+#endif
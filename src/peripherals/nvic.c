@@ -7,12 +7,111 @@
 
 #include "nvic.h"
 
+#include "mode.h"
 #include "nvic_reg.h"
 #include "scb_reg.h"
+#ifdef IRQ_STATS
+#include "systick.h"
+#endif
+
+/*** NVIC local macros ***/
+
+#ifdef RAM_VECTORS
+#define NVIC_NUMBER_OF_SYSTEM_VECTORS	16
+#define NVIC_NUMBER_OF_VECTORS			(NVIC_NUMBER_OF_SYSTEM_VECTORS + NVIC_IT_LPUART1 + 1)
+#endif
+
+#ifdef IRQ_STATS
+/*** NVIC local structures ***/
+
+typedef struct {
+	unsigned int min;
+	unsigned int max;
+	unsigned int sum;
+	unsigned int count;
+} NVIC_stats_metric_t;
+
+typedef struct {
+	NVIC_stats_metric_t latency;
+	NVIC_stats_metric_t duration;
+	unsigned int masked_max;
+	unsigned int masked_start_count;
+	unsigned char masked;
+} NVIC_stats_t;
+#endif
 
 /*** NVIC local global variables ***/
 
 extern unsigned int __Vectors;
+#ifdef RAM_VECTORS
+// VTOR requires the table to be aligned on its size rounded up to a power of 2.
+static volatile NVIC_handler_t nvic_ram_vectors[NVIC_NUMBER_OF_VECTORS] __attribute__((section(".ram_vectors"), aligned(256)));
+#endif
+#ifdef IRQ_STATS
+static const NVIC_interrupt_t nvic_stats_it_num[NVIC_STATS_SOURCE_LAST] = {
+	NVIC_IT_LPUART1,
+	NVIC_IT_TIM21,
+	NVIC_IT_RTC,
+	NVIC_IT_LPTIM1,
+	NVIC_IT_FLASH
+};
+static NVIC_stats_t nvic_stats[NVIC_STATS_SOURCE_LAST];
+
+/*** NVIC local functions ***/
+
+/* GET INSTRUMENTED SOURCE INDEX OF AN INTERRUPT LINE.
+ * @param it_num:	Interrupt number.
+ * @return source:	Source index, NVIC_STATS_SOURCE_LAST if the interrupt is not instrumented.
+ */
+static NVIC_stats_source_t NVIC_stats_get_source(NVIC_interrupt_t it_num) {
+	// Local variables.
+	NVIC_stats_source_t source = 0;
+	// Search interrupt number.
+	for (source=0 ; source<NVIC_STATS_SOURCE_LAST ; source++) {
+		if (nvic_stats_it_num[source] == it_num) break;
+	}
+	return source;
+}
+
+/* UPDATE A STATISTIC WITH A NEW SAMPLE.
+ * @param metric:	Statistic to update.
+ * @param value:	New sample in core clock cycles.
+ * @return:			None.
+ */
+static void NVIC_stats_update_metric(NVIC_stats_metric_t* metric, unsigned int value) {
+	// Restart average on overflow.
+	if (((metric -> sum) + value) < (metric -> sum)) {
+		(metric -> sum) = 0;
+		(metric -> count) = 0;
+	}
+	// Update minimum and maximum.
+	if (((metric -> min) > value) || ((metric -> count) == 0)) {
+		(metric -> min) = value;
+	}
+	if ((metric -> max) < value) {
+		(metric -> max) = value;
+	}
+	(metric -> sum) += value;
+	(metric -> count)++;
+}
+
+/* RECORD THE LATENCY BOUND OF ALL SOURCES WHICH BECAME PENDING DURING A BLOCKING SECTION.
+ * @param it_num:			Interrupt number of the blocking handler.
+ * @param blocking_count:	Duration of the blocking section in core clock cycles.
+ * @return:					None.
+ */
+static void NVIC_stats_record_blocking(NVIC_interrupt_t it_num, unsigned int blocking_count) {
+	// Local variables.
+	NVIC_stats_source_t source = 0;
+	unsigned int pending = (NVIC -> ISPR) & (NVIC -> ISER);
+	// A pending source waited at most the whole blocking section.
+	for (source=0 ; source<NVIC_STATS_SOURCE_LAST ; source++) {
+		if ((nvic_stats_it_num[source] != it_num) && ((pending & (0b1 << nvic_stats_it_num[source])) != 0)) {
+			NVIC_stats_update_metric(&(nvic_stats[source].latency), blocking_count);
+		}
+	}
+}
+#endif
 
 /*** NVIC functions ***/
 
@@ -21,7 +120,17 @@ extern unsigned int __Vectors;
  * @return:	None.
  */
 void NVIC_init(void) {
+#ifdef RAM_VECTORS
+	// Local variables.
+	unsigned char vector_idx = 0;
+	// Copy flash table to RAM.
+	for (vector_idx=0 ; vector_idx<NVIC_NUMBER_OF_VECTORS ; vector_idx++) {
+		nvic_ram_vectors[vector_idx] = ((NVIC_handler_t*) &__Vectors)[vector_idx];
+	}
+	SCB -> VTOR = (unsigned int) nvic_ram_vectors;
+#else
 	SCB -> VTOR = (unsigned int) &__Vectors;
+#endif
 }
 
 /* ENABLE AN INTERRUPT LINE.
@@ -29,6 +138,22 @@ void NVIC_init(void) {
  * @return: 		None.
  */
 void NVIC_enable_interrupt(NVIC_interrupt_t it_num) {
+#ifdef IRQ_STATS
+	// Local variables.
+	NVIC_stats_source_t source = NVIC_stats_get_source(it_num);
+	unsigned int masked_count = 0;
+	// Record masked time if an event was actually delayed.
+	if ((source < NVIC_STATS_SOURCE_LAST) && (nvic_stats[source].masked != 0)) {
+		nvic_stats[source].masked = 0;
+		if (((NVIC -> ISPR) & (0b1 << (it_num & 0x1F))) != 0) {
+			masked_count = SYSTICK_get_elapsed(nvic_stats[source].masked_start_count);
+			if (masked_count > nvic_stats[source].masked_max) {
+				nvic_stats[source].masked_max = masked_count;
+			}
+			NVIC_stats_update_metric(&(nvic_stats[source].latency), masked_count);
+		}
+	}
+#endif
 	NVIC -> ISER = (0b1 << (it_num & 0x1F));
 }
 
@@ -38,6 +163,15 @@ void NVIC_enable_interrupt(NVIC_interrupt_t it_num) {
  */
 void NVIC_disable_interrupt(NVIC_interrupt_t it_num) {
 	NVIC -> ICER = (0b1 << (it_num & 0x1F));
+#ifdef IRQ_STATS
+	// Local variables.
+	NVIC_stats_source_t source = NVIC_stats_get_source(it_num);
+	// Start masked window.
+	if ((source < NVIC_STATS_SOURCE_LAST) && (nvic_stats[source].masked == 0)) {
+		nvic_stats[source].masked_start_count = SYSTICK_get_count();
+		nvic_stats[source].masked = 1;
+	}
+#endif
 }
 
 /* SET THE PRIORITY OF AN INTERRUPT LINE.
@@ -53,3 +187,79 @@ void NVIC_set_priority(NVIC_interrupt_t it_num, unsigned char priority) {
 		NVIC -> IPR[(it_num >> 2)] |= ((priority << 6) << (8 * (it_num % 4)));
 	}
 }
+
+#ifdef RAM_VECTORS
+/* INSTALL A NEW HANDLER FOR AN INTERRUPT LINE.
+ * @param it_num:	Interrupt number (use enum defined in 'nvic.h').
+ * @param handler:	Handler to call on interrupt.
+ * @return:			None.
+ */
+void NVIC_set_handler(NVIC_interrupt_t it_num, NVIC_handler_t handler) {
+	nvic_ram_vectors[NVIC_NUMBER_OF_SYSTEM_VECTORS + it_num] = handler;
+}
+#endif
+
+#ifdef IRQ_STATS
+/* START INTERRUPT HANDLER INSTRUMENTATION (CALLED THROUGH NVIC_STATS_ENTER MACRO).
+ * @param:	None.
+ * @return:	Handler entry timestamp.
+ */
+unsigned int NVIC_stats_enter(void) {
+	return SYSTICK_get_count();
+}
+
+/* END INTERRUPT HANDLER INSTRUMENTATION (CALLED THROUGH NVIC_STATS_EXIT MACRO).
+ * @param it_num:		Interrupt number of the handler.
+ * @param entry_count:	Handler entry timestamp.
+ * @return:				None.
+ */
+void NVIC_stats_exit(NVIC_interrupt_t it_num, unsigned int entry_count) {
+	// Local variables.
+	NVIC_stats_source_t source = NVIC_stats_get_source(it_num);
+	unsigned int duration_count = SYSTICK_get_elapsed(entry_count);
+	// Update handler duration.
+	if (source < NVIC_STATS_SOURCE_LAST) {
+		NVIC_stats_update_metric(&(nvic_stats[source].duration), duration_count);
+	}
+	// Update latency of the sources blocked by this handler.
+	NVIC_stats_record_blocking(it_num, duration_count);
+}
+
+/* GET INTERRUPT STATISTICS.
+ * @param source:		Instrumented interrupt source.
+ * @param stats_idx:	Statistic to read.
+ * @param value_us:		Pointer that will contain the statistic in us.
+ * @return:				None.
+ */
+void NVIC_get_stats(NVIC_stats_source_t source, NVIC_stats_index_t stats_idx, unsigned int* value_us) {
+	// Local variables.
+	unsigned int value_count = 0;
+	NVIC_stats_metric_t* metric = 0;
+	// Check parameter.
+	if (source >= NVIC_STATS_SOURCE_LAST) return;
+	// Select metric.
+	metric = (stats_idx < NVIC_STATS_DURATION_MIN_US) ? &(nvic_stats[source].latency) : &(nvic_stats[source].duration);
+	switch (stats_idx) {
+	case NVIC_STATS_LATENCY_MIN_US:
+	case NVIC_STATS_DURATION_MIN_US:
+		value_count = (metric -> min);
+		break;
+	case NVIC_STATS_LATENCY_MAX_US:
+	case NVIC_STATS_DURATION_MAX_US:
+		value_count = (metric -> max);
+		break;
+	case NVIC_STATS_LATENCY_AVERAGE_US:
+	case NVIC_STATS_DURATION_AVERAGE_US:
+		if ((metric -> count) != 0) {
+			value_count = (metric -> sum) / (metric -> count);
+		}
+		break;
+	case NVIC_STATS_MASKED_MAX_US:
+		value_count = nvic_stats[source].masked_max;
+		break;
+	default:
+		break;
+	}
+	(*value_us) = SYSTICK_convert_to_us(value_count);
+}
+#endif
@@ -0,0 +1,262 @@
+/*
+ * nvm.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "nvm.h"
+
+#include "flash_reg.h"
+#include "mode.h"
+#include "nvic.h"
+#include "pwr.h"
+
+#ifdef NVM_QUEUE
+/*** NVM local macros ***/
+
+#define NVM_WRITE_QUEUE_LENGTH		8
+#define NVM_PEKEY1					0x89ABCDEF
+#define NVM_PEKEY2					0x02030405
+#define NVM_SR_ERROR_MASK			0x00032F00 // FWWERR, NOTZEROERR, RDERR, OPTVERR, SIZERR, PGAERR and WRPERR.
+
+/*** NVM local structures ***/
+
+typedef struct {
+	unsigned short word_offset;
+	unsigned int data;
+} NVM_write_request_t;
+
+typedef struct {
+	NVM_write_request_t queue[NVM_WRITE_QUEUE_LENGTH];
+	volatile unsigned char queue_head;
+	volatile unsigned char queue_count;
+	volatile unsigned char busy;
+	volatile unsigned int error_count;
+} NVM_context_t;
+
+/*** NVM local global variables ***/
+
+static NVM_context_t nvm_ctx;
+
+/*** NVM local functions ***/
+
+/* START PROGRAMMING THE WORD AT THE HEAD OF THE QUEUE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void NVM_start_next_write(void) {
+	// Local variables.
+	NVM_write_request_t* request = &(nvm_ctx.queue[nvm_ctx.queue_head]);
+	// Write word, end of operation is signaled by interrupt.
+	nvm_ctx.busy = 1;
+	*((volatile unsigned int*) (EEPROM_START_ADDRESS + ((request -> word_offset) << 2))) = (request -> data);
+}
+
+/* UNLOCK PECR REGISTER AND DATA EEPROM.
+ * @param:	None.
+ * @return:	None.
+ */
+static void NVM_unlock(void) {
+	// Check PELOCK bit.
+	if (((FLASH -> PECR) & (0b1 << 0)) != 0) {
+		FLASH -> PEKEYR = NVM_PEKEY1;
+		FLASH -> PEKEYR = NVM_PEKEY2;
+	}
+	// Enable end of programming and error interrupts.
+	FLASH -> PECR |= (0b11 << 16); // EOPIE='1' and ERRIE='1'.
+}
+
+/* LOCK PECR REGISTER AND DATA EEPROM.
+ * @param:	None.
+ * @return:	None.
+ */
+static void NVM_lock(void) {
+	// Disable interrupts and lock.
+	FLASH -> PECR &= ~(0b11 << 16); // EOPIE='0' and ERRIE='0'.
+	FLASH -> PECR |= (0b1 << 0); // PELOCK='1'.
+}
+
+/* NVM INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void FLASH_IRQHandler(void) {
+	NVIC_STATS_ENTER(NVIC_IT_FLASH);
+	// Count and clear errors (write 1 to clear).
+	if (((FLASH -> SR) & NVM_SR_ERROR_MASK) != 0) {
+		nvm_ctx.error_count++;
+		FLASH -> SR = NVM_SR_ERROR_MASK;
+	}
+	// End of programming.
+	if (((FLASH -> SR) & (0b1 << 1)) != 0) {
+		// Clear EOP flag (write 1 to clear).
+		FLASH -> SR = (0b1 << 1);
+	}
+	// Release queue entry once the NVM is no longer busy.
+	if ((nvm_ctx.busy != 0) && (((FLASH -> SR) & (0b1 << 0)) == 0)) {
+		nvm_ctx.busy = 0;
+		nvm_ctx.queue_head = (nvm_ctx.queue_head + 1) % NVM_WRITE_QUEUE_LENGTH;
+		nvm_ctx.queue_count--;
+		// Chain next write or lock NVM.
+		if (nvm_ctx.queue_count > 0) {
+			NVM_start_next_write();
+		}
+		else {
+			NVM_lock();
+			NVIC_disable_interrupt(NVIC_IT_FLASH);
+		}
+	}
+	NVIC_STATS_EXIT(NVIC_IT_FLASH);
+}
+
+/* SEARCH A PENDING (NOT STARTED) WRITE REQUEST FOR A GIVEN WORD.
+ * @param word_offset:	Word offset in data EEPROM.
+ * @return request:		Pointer to the pending request, 0 if not found.
+ */
+static NVM_write_request_t* NVM_find_pending_request(unsigned short word_offset) {
+	// Local variables.
+	NVM_write_request_t* request = 0;
+	unsigned char idx = 0;
+	unsigned char queue_idx = 0;
+	// The head request is skipped when its programming is ongoing.
+	for (idx=nvm_ctx.busy ; idx<nvm_ctx.queue_count ; idx++) {
+		queue_idx = (nvm_ctx.queue_head + idx) % NVM_WRITE_QUEUE_LENGTH;
+		if (nvm_ctx.queue[queue_idx].word_offset == word_offset) {
+			request = &(nvm_ctx.queue[queue_idx]);
+		}
+	}
+	return request;
+}
+
+/* QUEUE A WORD WRITE, MERGING IT WITH A PENDING REQUEST ON THE SAME WORD.
+ * @param word_offset:	Word offset in data EEPROM.
+ * @param data:			Word value.
+ * @param byte_mask:	Bytes of the word to update (bit i for byte i).
+ * @return:				None.
+ */
+static void NVM_queue_write(unsigned short word_offset, unsigned int data, unsigned char byte_mask) {
+	// Local variables.
+	NVM_write_request_t* request = 0;
+	unsigned int word_mask = 0;
+	unsigned int current_word = 0;
+	unsigned char idx = 0;
+	// Check address.
+	if (word_offset >= (EEPROM_SIZE >> 2)) return;
+	// Build word mask.
+	for (idx=0 ; idx<4 ; idx++) {
+		if ((byte_mask & (0b1 << idx)) != 0) {
+			word_mask |= (0xFF << (8 * idx));
+		}
+	}
+	// Wait for a free slot if queue is full.
+	while (nvm_ctx.queue_count >= NVM_WRITE_QUEUE_LENGTH) {
+		PWR_enter_sleep_mode();
+	}
+	// Protect queue from interrupt.
+	NVIC_disable_interrupt(NVIC_IT_FLASH);
+	// Batch with pending request if possible.
+	request = NVM_find_pending_request(word_offset);
+	if (request != 0) {
+		(request -> data) = ((request -> data) & ~word_mask) | (data & word_mask);
+	}
+	else {
+		// Read current value (possibly being programmed) to preserve other bytes.
+		current_word = *((volatile unsigned int*) (EEPROM_START_ADDRESS + (word_offset << 2)));
+		request = &(nvm_ctx.queue[(nvm_ctx.queue_head + nvm_ctx.queue_count) % NVM_WRITE_QUEUE_LENGTH]);
+		(request -> word_offset) = word_offset;
+		(request -> data) = (current_word & ~word_mask) | (data & word_mask);
+		nvm_ctx.queue_count++;
+		// Start programming if NVM is idle.
+		if (nvm_ctx.busy == 0) {
+			NVM_unlock();
+			NVM_start_next_write();
+		}
+	}
+	NVIC_enable_interrupt(NVIC_IT_FLASH);
+}
+
+/*** NVM functions ***/
+
+/* INIT NVM INTERFACE.
+ * @param:	None.
+ * @return:	None.
+ */
+void NVM_init(void) {
+	// Init context.
+	nvm_ctx.queue_head = 0;
+	nvm_ctx.queue_count = 0;
+	nvm_ctx.busy = 0;
+	nvm_ctx.error_count = 0;
+	// Set interrupt priority.
+	NVIC_set_priority(NVIC_IT_FLASH, 3);
+}
+
+/* READ A BYTE STORED IN NVM (INCLUDING PENDING WRITES).
+ * @param address_offset:	Address offset starting from EEPROM start address.
+ * @param data:				Pointer that will contain the read byte.
+ * @return:					None.
+ */
+void NVM_read_byte(unsigned short address_offset, unsigned char* data) {
+	// Local variables.
+	NVM_write_request_t* request = 0;
+	// Check address.
+	if (address_offset >= EEPROM_SIZE) return;
+	// Read from pending request if any.
+	NVIC_disable_interrupt(NVIC_IT_FLASH);
+	request = NVM_find_pending_request(address_offset >> 2);
+	if (request != 0) {
+		(*data) = (((request -> data) >> (8 * (address_offset % 4))) & 0xFF);
+	}
+	else {
+		(*data) = *((volatile unsigned char*) (EEPROM_START_ADDRESS + address_offset));
+	}
+	if (nvm_ctx.queue_count > 0) {
+		NVIC_enable_interrupt(NVIC_IT_FLASH);
+	}
+}
+
+/* QUEUE A BYTE WRITE IN NVM.
+ * @param address_offset:	Address offset starting from EEPROM start address.
+ * @param data:				Byte to write.
+ * @return:					None.
+ */
+void NVM_write_byte(unsigned short address_offset, unsigned char data) {
+	NVM_queue_write((address_offset >> 2), (((unsigned int) data) << (8 * (address_offset % 4))), (0b1 << (address_offset % 4)));
+}
+
+/* QUEUE A WORD WRITE IN NVM.
+ * @param address_offset:	Address offset starting from EEPROM start address (must be word aligned).
+ * @param data:				Word to write.
+ * @return:					None.
+ */
+void NVM_write_word(unsigned short address_offset, unsigned int data) {
+	NVM_queue_write((address_offset >> 2), data, 0b1111);
+}
+
+/* GET NVM STATUS.
+ * @param:	None.
+ * @return:	1 if write requests are pending, 0 otherwise.
+ */
+unsigned char NVM_is_busy(void) {
+	return (nvm_ctx.queue_count > 0);
+}
+
+/* WAIT FOR ALL PENDING WRITES IN SLEEP MODE.
+ * @param:	None.
+ * @return:	None.
+ */
+void NVM_flush(void) {
+	while (nvm_ctx.queue_count > 0) {
+		PWR_enter_sleep_mode();
+	}
+}
+
+/* GET NVM PROGRAMMING ERROR COUNT.
+ * @param:	None.
+ * @return:	Number of failed operations since init.
+ */
+unsigned int NVM_get_error_count(void) {
+	return nvm_ctx.error_count;
+}
+#endif
@@ -83,3 +83,34 @@ void PWR_enter_stop_mode(void) {
 	SCB -> SCR |= (0b1 << 2); // SLEEPDEEP='1'.
 	__asm volatile ("wfi"); // Wait For Interrupt core instruction.
 }
+
+/* FUNCTION TO ENTER STANDBY MODE (RAM AND REGISTERS ARE LOST, WAKE-UP IS A RESET).
+ * @param:	None.
+ * @return:	None.
+ */
+void PWR_enter_standby_mode(void) {
+	// Clear WUF flag.
+	PWR -> CR |= (0b1 << 2); // CWUF='1'.
+	// Enter standby mode when CPU enters deepsleep.
+	PWR -> CR |= (0b1 << 1); // PDDS='1'.
+	// Clear all EXTI line, RTC an peripherals interrupt pending bits.
+	RCC -> CICR |= 0x000001BF;
+	EXTI -> PR |= 0x007BFFFF; // PIFx='1'.
+	RTC -> ISR &= 0xFFFF005F; // Reset alarms, wake-up, tamper and timestamp flags.
+	NVIC -> ICPR = 0xFFFFFFFF; // CLEARPENDx='1'.
+	// Enter standby mode.
+	SCB -> SCR |= (0b1 << 2); // SLEEPDEEP='1'.
+	__asm volatile ("wfi"); // Wait For Interrupt core instruction.
+}
+
+/* GET AND CLEAR STANDBY FLAG.
+ * @param:	None.
+ * @return:	1 if the MCU was in standby mode before the last reset, 0 otherwise.
+ */
+unsigned char PWR_get_standby_flag(void) {
+	// Local variables.
+	unsigned char standby_flag = (((PWR -> CSR) & (0b1 << 1)) != 0) ? 1 : 0; // SBF.
+	// Clear flag.
+	PWR -> CR |= (0b1 << 3); // CSBF='1'.
+	return standby_flag;
+}
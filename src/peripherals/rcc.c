@@ -7,9 +7,33 @@
 
 #include "rcc.h"
 
+#include "mode.h"
 #include "nvic.h"
 #include "pwr.h"
 #include "rcc_reg.h"
+#ifdef MSI_CALIBRATION
+#include "tim.h"
+#endif
+
+#ifdef MSI_CALIBRATION
+/*** RCC local macros ***/
+
+#define RCC_MSI_CALIBRATION_CAPTURES		8
+#define RCC_MSI_CALIBRATION_TARGET_TICKS	((RCC_MSI_FREQUENCY_KHZ * 1000 * RCC_MSI_CALIBRATION_CAPTURES * TIM21_MSI_CAPTURE_PRESCALER) / (RCC_LSE_FREQUENCY_HZ))
+#define RCC_MSI_CALIBRATION_TOLERANCE_TICKS	8 // 0.2% of target.
+#define RCC_MSI_TRIM_MIN					(-128)
+#define RCC_MSI_TRIM_MAX					127
+
+/*** RCC local functions ***/
+
+/* COMPUTE ABSOLUTE DIFFERENCE BETWEEN MEASURED AND TARGET MSI TICKS.
+ * @param msi_ticks:	Measured number of MSI ticks.
+ * @return:				Absolute error in MSI ticks.
+ */
+static unsigned int RCC_get_msi_error(unsigned int msi_ticks) {
+	return (msi_ticks > RCC_MSI_CALIBRATION_TARGET_TICKS) ? (msi_ticks - RCC_MSI_CALIBRATION_TARGET_TICKS) : (RCC_MSI_CALIBRATION_TARGET_TICKS - msi_ticks);
+}
+#endif
 
 /*** RCC functions ***/
 
@@ -62,3 +86,73 @@ void RCC_enable_lse(void) {
 	}
 	NVIC_disable_interrupt(NVIC_IT_RCC_CRS);
 }
+
+#ifdef MSI_CALIBRATION
+/* TRIM MSI OSCILLATOR AGAINST LSE.
+ * @param max_steps:	Maximum number of trimming steps to perform (1 for periodic tracking, more at boot).
+ * @return:				None.
+ */
+void RCC_calibrate_msi(unsigned char max_steps) {
+	// Local variables.
+	unsigned char step_idx = 0;
+	unsigned int msi_ticks = 0;
+	unsigned int msi_error = 0;
+	unsigned int previous_msi_error = 0;
+	signed char msi_trim = RCC_get_msi_trim();
+	signed char previous_msi_trim = msi_trim;
+	// Measure and step trimming value towards target.
+	for (step_idx=0 ; step_idx<=max_steps ; step_idx++) {
+		// Measure MSI against LSE.
+		if (TIM21_measure_msi(RCC_MSI_CALIBRATION_CAPTURES, &msi_ticks) == 0) break;
+		msi_error = RCC_get_msi_error(msi_ticks);
+		// Revert last step if it made things worse (trimming step larger than tolerance).
+		if ((step_idx > 0) && (msi_error > previous_msi_error)) {
+			RCC_set_msi_trim(previous_msi_trim);
+			break;
+		}
+		// Exit if frequency is within tolerance or steps budget is reached.
+		if ((msi_error <= RCC_MSI_CALIBRATION_TOLERANCE_TICKS) || (step_idx >= max_steps)) break;
+		// Compute next trimming value.
+		previous_msi_trim = msi_trim;
+		previous_msi_error = msi_error;
+		if (msi_ticks > RCC_MSI_CALIBRATION_TARGET_TICKS) {
+			if (msi_trim <= RCC_MSI_TRIM_MIN) break;
+			msi_trim--;
+		}
+		else {
+			if (msi_trim >= RCC_MSI_TRIM_MAX) break;
+			msi_trim++;
+		}
+		RCC_set_msi_trim(msi_trim);
+	}
+}
+#endif
+
+/* SET MSI USER TRIMMING VALUE.
+ * @param msi_trim:	Signed trimming value added to factory calibration.
+ * @return:			None.
+ */
+void RCC_set_msi_trim(signed char msi_trim) {
+	RCC -> ICSCR &= ~(0xFF << 24);
+	RCC -> ICSCR |= ((((unsigned int) msi_trim) & 0xFF) << 24); // MSITRIM.
+}
+
+/* GET MSI USER TRIMMING VALUE.
+ * @param:	None.
+ * @return:	Signed trimming value added to factory calibration.
+ */
+signed char RCC_get_msi_trim(void) {
+	return (signed char) (((RCC -> ICSCR) >> 24) & 0xFF);
+}
+
+/* GET AND CLEAR RESET FLAGS.
+ * @param:	None.
+ * @return:	Reset flags of the last reset (RCC_CSR[31:24], see RCC_RESET_FLAG_* masks).
+ */
+unsigned char RCC_get_reset_flags(void) {
+	// Local variables.
+	unsigned char reset_flags = (unsigned char) (((RCC -> CSR) >> 24) & 0xFF);
+	// Clear flags for next reset.
+	RCC -> CSR |= (0b1 << 23); // RMVF='1'.
+	return reset_flags;
+}
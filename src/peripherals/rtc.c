@@ -19,10 +19,13 @@
 
 #define RTC_INIT_TIMEOUT_COUNT		1000
 #define RTC_WAKEUP_TIMER_DELAY_MAX	0xFFFF
+#define RTC_NUMBER_OF_MONTHS		12
 
 /*** RTC local global variables ***/
 
 static volatile unsigned char rtc_wakeup_timer_flag = 0;
+static volatile unsigned char rtc_alarm_flag = 0;
+static const unsigned short rtc_cumulative_days[RTC_NUMBER_OF_MONTHS] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
 
 /*** RTC local functions ***/
 
@@ -31,6 +34,7 @@ static volatile unsigned char rtc_wakeup_timer_flag = 0;
  * @return:	None.
  */
 void __attribute__((optimize("-O0"))) RTC_IRQHandler(void) {
+	NVIC_STATS_ENTER(NVIC_IT_RTC);
 	// Wake-up timer interrupt.
 	if (((RTC -> ISR) & (0b1 << 10)) != 0) {
 		// Set local flag.
@@ -41,6 +45,17 @@ void __attribute__((optimize("-O0"))) RTC_IRQHandler(void) {
 		RTC -> ISR &= ~(0b1 << 10); // WUTF='0'.
 		EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
 	}
+	// Alarm A interrupt.
+	if (((RTC -> ISR) & (0b1 << 8)) != 0) {
+		// Set local flag.
+		if (((RTC -> CR) & (0b1 << 12)) != 0) {
+			rtc_alarm_flag = 1;
+		}
+		// Clear flags.
+		RTC -> ISR &= ~(0b1 << 8); // ALRAF='0'.
+		EXTI -> PR |= (0b1 << EXTI_LINE_RTC_ALARM);
+	}
+	NVIC_STATS_EXIT(NVIC_IT_RTC);
 }
 
 /* ENTER INITIALIZATION MODE TO ENABLE RTC REGISTERS UPDATE.
@@ -74,6 +89,38 @@ static void RTC_exit_initialization_mode(void) {
 	RTC -> ISR &= ~(0b1 << 7); // INIT='0'.
 }
 
+/* CONVERT A BCD FIELD TO BINARY.
+ * @param bcd_value:	BCD value.
+ * @return:				Binary value.
+ */
+static unsigned int RTC_bcd_to_binary(unsigned int bcd_value) {
+	return ((((bcd_value >> 4) & 0x0F) * 10) + (bcd_value & 0x0F));
+}
+
+/* CONVERT A BINARY VALUE TO BCD FIELD.
+ * @param binary_value:	Binary value (0 to 99).
+ * @return:				BCD value.
+ */
+static unsigned int RTC_binary_to_bcd(unsigned int binary_value) {
+	return (((binary_value / 10) << 4) + (binary_value % 10));
+}
+
+/* CONFIGURE RTC WAKE-UP TIMER AND ALARM INTERRUPT PATHS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RTC_configure_interrupt(void) {
+	// Configure EXTI lines.
+	EXTI_configure_line(EXTI_LINE_RTC_WAKEUP_TIMER, EXTI_TRIGGER_RISING_EDGE);
+	EXTI_configure_line(EXTI_LINE_RTC_ALARM, EXTI_TRIGGER_RISING_EDGE);
+	// Clear flags.
+	RTC -> ISR &= ~((0b1 << 10) | (0b1 << 8)); // WUTF='0' and ALRAF='0'.
+	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER) | (0b1 << EXTI_LINE_RTC_ALARM);
+	// Set interrupt priority.
+	NVIC_set_priority(NVIC_IT_RTC, 2);
+	NVIC_enable_interrupt(NVIC_IT_RTC);
+}
+
 /*** RTC functions ***/
 
 /* RESET RTC PERIPHERAL.
@@ -119,15 +166,26 @@ void RTC_init(void) {
 	RTC -> CR &= ~(0b111 << 0);
 	RTC -> CR |= (0b100 << 0); // Wake-up timer clocked by RTC clock (1Hz).
 	RTC_exit_initialization_mode();
-	// Configure EXTI line.
-	EXTI_configure_line(EXTI_LINE_RTC_WAKEUP_TIMER, EXTI_TRIGGER_RISING_EDGE);
 	// Disable interrupt and clear all flags.
 	RTC -> CR &= ~(0b1 << 14);
 	RTC -> ISR &= 0xFFFE0000;
-	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
-	// Set interrupt priority.
-	NVIC_set_priority(NVIC_IT_RTC, 2);
-	NVIC_enable_interrupt(NVIC_IT_RTC);
+	RTC_configure_interrupt();
+}
+
+/* RESUME RTC AFTER STANDBY MODE (CALENDAR, CLOCK SOURCE AND WAKE-UP TIMER ARE KEPT).
+ * @param:	None.
+ * @return:	None.
+ */
+void RTC_resume(void) {
+	RTC_configure_interrupt();
+}
+
+/* GET RTC CLOCK SOURCE (LSI IS USED WHEN LSE FAILED).
+ * @param:	None.
+ * @return:	RTC clock source.
+ */
+RTC_clock_source_t RTC_get_clock_source(void) {
+	return (RTC_clock_source_t) (((RCC -> CSR) >> 16) & 0b11); // RTCSEL.
 }
 
 /* START RTC WAKE-UP TIMER.
@@ -171,6 +229,18 @@ void RTC_stop_wakeup_timer(void) {
 	RTC -> CR &= ~(0b1 << 14); // WUTE='0'.
 }
 
+/* RESTART RTC WAKE-UP TIMER FROM ZERO.
+ * @param delay_seconds:	Delay in seconds.
+ * @return:					None.
+ */
+void RTC_restart_wakeup_timer(unsigned int delay_seconds) {
+	// Stop timer and discard pending event.
+	RTC_stop_wakeup_timer();
+	RTC_clear_wakeup_timer_flag();
+	// Start new period.
+	RTC_start_wakeup_timer(delay_seconds);
+}
+
 /* RETURN THE CURRENT ALARM INTERRUPT STATUS.
  * @param:	None.
  * @return:	1 if the RTC interrupt occured, 0 otherwise.
@@ -189,3 +259,117 @@ void RTC_clear_wakeup_timer_flag(void) {
 	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
 	rtc_wakeup_timer_flag = 0;
 }
+
+/* START RTC ALARM A (CALENDAR KEEPS RUNNING).
+ * @param delay_seconds:	Delay in seconds.
+ * @return:					None.
+ */
+void RTC_start_alarm(unsigned int delay_seconds) {
+	// Local variables.
+	unsigned int tr = 0;
+	unsigned int alarm_seconds = 0;
+	unsigned int loop_count = 0;
+	// Clamp parameter.
+	if (delay_seconds < 1) {
+		delay_seconds = 1;
+	}
+	if (delay_seconds > RTC_ALARM_DELAY_MAX_SECONDS) {
+		delay_seconds = RTC_ALARM_DELAY_MAX_SECONDS;
+	}
+	// Compute alarm time within the current hour.
+	tr = (RTC -> TR);
+	alarm_seconds = (RTC_bcd_to_binary((tr >> 8) & 0x7F) * 60) + RTC_bcd_to_binary(tr & 0x7F) + delay_seconds;
+	alarm_seconds %= 3600;
+	// Alarm registers only require write access.
+	RTC -> WPR = 0xCA;
+	RTC -> WPR = 0x53;
+	RTC -> CR &= ~(0b1 << 8); // ALRAE='0'.
+	while (((RTC -> ISR) & (0b1 << 0)) == 0) {
+		// Wait for ALRAWF='1' or timeout.
+		loop_count++;
+		if (loop_count > RTC_INIT_TIMEOUT_COUNT) break;
+	}
+	RTC -> ALRMAR = (0b1 << 31) | (0b1 << 23) | (RTC_binary_to_bcd(alarm_seconds / 60) << 8) | (RTC_binary_to_bcd(alarm_seconds % 60) << 0); // MSK4='1' and MSK3='1' (date and hours ignored).
+	RTC -> ISR &= ~(0b1 << 8); // ALRAF='0'.
+	RTC -> CR |= (0b1 << 12) | (0b1 << 8); // ALRAIE='1' and ALRAE='1'.
+	RTC -> WPR = 0xFF;
+	rtc_alarm_flag = 0;
+}
+
+/* STOP RTC ALARM A.
+ * @param:	None.
+ * @return:	None.
+ */
+void RTC_stop_alarm(void) {
+	RTC -> WPR = 0xCA;
+	RTC -> WPR = 0x53;
+	RTC -> CR &= ~((0b1 << 12) | (0b1 << 8)); // ALRAIE='0' and ALRAE='0'.
+	RTC -> WPR = 0xFF;
+	rtc_alarm_flag = 0;
+}
+
+/* RETURN THE CURRENT ALARM A INTERRUPT STATUS.
+ * @param:	None.
+ * @return:	1 if the alarm occured, 0 otherwise.
+ */
+volatile unsigned char RTC_get_alarm_flag(void) {
+	return rtc_alarm_flag;
+}
+
+/* CLEAR ALARM A INTERRUPT FLAG.
+ * @param:	None.
+ * @return:	None.
+ */
+void RTC_clear_alarm_flag(void) {
+	rtc_alarm_flag = 0;
+}
+
+/* GET TIME ELAPSED SINCE RTC RESET.
+ * @param:	None.
+ * @return:	Number of seconds since RTC calendar origin (01/01/2000 00:00:00 after reset).
+ */
+unsigned int RTC_get_uptime_seconds(void) {
+	// Local variables.
+	unsigned int tr = 0;
+	unsigned int dr = 0;
+	unsigned int year = 0;
+	unsigned int month = 0;
+	unsigned int days = 0;
+	// Shadow registers are bypassed: read TR until it is consistent with DR.
+	do {
+		tr = (RTC -> TR);
+		dr = (RTC -> DR);
+	}
+	while (tr != (RTC -> TR));
+	// Convert date to number of days.
+	year = RTC_bcd_to_binary((dr >> 16) & 0xFF);
+	month = RTC_bcd_to_binary((dr >> 8) & 0x1F);
+	if ((month < 1) || (month > RTC_NUMBER_OF_MONTHS)) {
+		month = 1;
+	}
+	days = (year * 365) + ((year + 3) / 4) + rtc_cumulative_days[month - 1] + RTC_bcd_to_binary(dr & 0x3F) - 1;
+	if (((year % 4) == 0) && (month > 2)) {
+		days++;
+	}
+	// Add time.
+	return ((days * 86400) + (RTC_bcd_to_binary((tr >> 16) & 0x3F) * 3600) + (RTC_bcd_to_binary((tr >> 8) & 0x7F) * 60) + RTC_bcd_to_binary(tr & 0x7F));
+}
+
+/* WRITE A BACKUP REGISTER.
+ * @param register_idx:	Register index.
+ * @param value:		Value to write.
+ * @return:				None.
+ */
+void RTC_write_backup_register(unsigned char register_idx, unsigned int value) {
+	if (register_idx < RTC_NUMBER_OF_BACKUP_REGISTERS) {
+		(&(RTC -> BKP0R))[register_idx] = value;
+	}
+}
+
+/* READ A BACKUP REGISTER.
+ * @param register_idx:	Register index.
+ * @return:				Register value (0 if the index is invalid).
+ */
+unsigned int RTC_read_backup_register(unsigned char register_idx) {
+	return (register_idx < RTC_NUMBER_OF_BACKUP_REGISTERS) ? ((&(RTC -> BKP0R))[register_idx]) : 0;
+}
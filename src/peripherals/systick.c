@@ -0,0 +1,92 @@
+/*
+ * systick.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "systick.h"
+
+#include "rcc.h"
+#include "systick_reg.h"
+
+/*** SYSTICK local global variables ***/
+
+static volatile unsigned int systick_overflow_count;
+
+/*** SYSTICK local functions ***/
+
+/* SYSTEM TICK INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void SysTick_Handler(void) {
+	// Extend counter beyond 24 bits.
+	systick_overflow_count++;
+}
+
+/*** SYSTICK functions ***/
+
+/* INIT SYSTICK AS A FREE RUNNING TIMESTAMP COUNTER.
+ * @param:	None.
+ * @return:	None.
+ */
+void SYSTICK_init(void) {
+	// Disable counter during configuration.
+	SYSTICK -> CSR &= ~(0b1 << 0); // ENABLE='0'.
+	// Use full counter range.
+	SYSTICK -> RVR = SYSTICK_COUNTER_MASK;
+	SYSTICK -> CVR = 0;
+	systick_overflow_count = 0;
+	// Processor clock, interrupt on wrap (every 8s).
+	SYSTICK -> CSR |= (0b1 << 2); // CLKSOURCE='1'.
+	SYSTICK -> CSR |= (0b1 << 1); // TICKINT='1'.
+	// Start counter.
+	SYSTICK -> CSR |= (0b1 << 0); // ENABLE='1'.
+}
+
+/* GET CURRENT TIMESTAMP (SYSTICK IS STOPPED IN STOP MODE).
+ * @param:	None.
+ * @return:	Up-counting timestamp in core clock cycles (modulo 2^24).
+ */
+unsigned int SYSTICK_get_count(void) {
+	// Hardware counter is counting down.
+	return (SYSTICK_COUNTER_MASK - (SYSTICK -> CVR));
+}
+
+/* GET ELAPSED TIME SINCE A PREVIOUS TIMESTAMP.
+ * @param start_count:	Timestamp returned by SYSTICK_get_count().
+ * @return:				Elapsed core clock cycles.
+ */
+unsigned int SYSTICK_get_elapsed(unsigned int start_count) {
+	return ((SYSTICK_get_count() - start_count) & SYSTICK_COUNTER_MASK);
+}
+
+/* CONVERT A NUMBER OF CORE CLOCK CYCLES TO MICROSECONDS.
+ * @param systick_count:	Number of core clock cycles.
+ * @return:					Corresponding duration in us.
+ */
+unsigned int SYSTICK_convert_to_us(unsigned int systick_count) {
+	unsigned long long us = systick_count;
+	us *= 1000;
+	return (unsigned int) ((us) / (RCC_MSI_FREQUENCY_KHZ));
+}
+
+/* GET TIME ELAPSED SINCE SYSTICK INIT (EXCLUDING STOP MODE).
+ * @param:	None.
+ * @return:	Elapsed time in us.
+ */
+unsigned int SYSTICK_get_time_us(void) {
+	// Local variables.
+	unsigned int overflow_count = 0;
+	unsigned int count = 0;
+	unsigned long long us = 0;
+	// Read again if the counter wrapped in the meantime.
+	do {
+		overflow_count = systick_overflow_count;
+		count = SYSTICK_get_count();
+	}
+	while (overflow_count != systick_overflow_count);
+	us = ((((unsigned long long) overflow_count) << 24) + count) * 1000;
+	return (unsigned int) ((us) / (RCC_MSI_FREQUENCY_KHZ));
+}
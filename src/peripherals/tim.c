@@ -8,6 +8,7 @@
 #include "tim.h"
 
 #include "mapping.h"
+#include "mode.h"
 #include "nvic.h"
 #include "rcc.h"
 #include "rcc_reg.h"
@@ -19,6 +20,7 @@
 #define TIM2_ARR_VALUE					((RCC_MSI_FREQUENCY_KHZ * 1000) / TIM2_PWM_FREQUENCY_HZ)
 #define TIM2_NUMBER_OF_CHANNELS			4
 #define TIM21_DIMMING_LUT_LENGTH		100
+#define TIM21_TIMEOUT_COUNT				1000000
 
 /*** TIM local structures ***/
 
@@ -58,6 +60,7 @@ static TIM21_context_t tim21_ctx;
  * @return:	None.
  */
 void __attribute__((optimize("-O0"))) TIM21_IRQHandler(void) {
+	NVIC_STATS_ENTER(NVIC_IT_TIM21);
 	// Check update flag.
 	if (((TIM21 -> SR) & (0b1 << 0)) != 0) {
 		// Update duty cycles.
@@ -88,6 +91,7 @@ void __attribute__((optimize("-O0"))) TIM21_IRQHandler(void) {
 		// Clear flag.
 		TIM21 -> SR &= ~(0b1 << 0);
 	}
+	NVIC_STATS_EXIT(NVIC_IT_TIM21);
 }
 
 /*** TIM functions ***/
@@ -167,6 +171,44 @@ void TIM2_stop(void) {
 	TIM2 -> CR1 &= ~(0b1 << 0); // CEN='0'.
 }
 
+#ifdef ADC_STREAM
+/* START TIM2 AS ADC CONVERSION TRIGGER.
+ * @param trigger_frequency_hz:	Conversion trigger frequency in Hz.
+ * @return:						None.
+ * Warning: PWM outputs are not available until TIM2_init() is called again.
+ */
+void TIM2_start_trigger(unsigned int trigger_frequency_hz) {
+	// Enable peripheral clock.
+	RCC -> APB1ENR |= (0b1 << 0); // TIM2EN='1'.
+	// Reset timer before configuration.
+	TIM2 -> CR1 &= ~(0b1 << 0); // CEN='0'.
+	TIM2 -> CCER &= 0xFFFFEEEE;
+	// Set trigger frequency.
+	TIM2 -> PSC = 0; // Timer input clock is SYSCLK.
+	TIM2 -> ARR = ((RCC_MSI_FREQUENCY_KHZ * 1000) / (trigger_frequency_hz)) - 1;
+	// Update event is used as trigger output.
+	TIM2 -> CR2 &= ~(0b111 << 4);
+	TIM2 -> CR2 |= (0b010 << 4); // MMS='010'.
+	// Generate event to update registers.
+	TIM2 -> EGR |= (0b1 << 0); // UG='1'.
+	// Enable counter.
+	TIM2 -> CNT = 0;
+	TIM2 -> CR1 |= (0b1 << 0); // CEN='1'.
+}
+
+/* STOP TIM2 ADC CONVERSION TRIGGER.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIM2_stop_trigger(void) {
+	// Disable counter and trigger output.
+	TIM2 -> CR1 &= ~(0b1 << 0); // CEN='0'.
+	TIM2 -> CR2 &= ~(0b111 << 4); // MMS='000'.
+	// Disable peripheral clock.
+	RCC -> APB1ENR &= ~(0b1 << 0); // TIM2EN='0'.
+}
+#endif
+
 /* INIT TIM21 FOR LED BLINKING OPERATION.
  * @param led_blink_period_ms:	LED blink period in ms.
  * @return:						None.
@@ -237,3 +279,65 @@ void TIM21_Stop(void) {
 unsigned char TIM21_IsSingleBlinkDone(void) {
 	return (tim21_ctx.single_blink_done);
 }
+
+#ifdef MSI_CALIBRATION
+/* MEASURE MSI FREQUENCY AGAINST LSE WITH TIM21 INPUT CAPTURE.
+ * @param number_of_captures:	Number of input captures to perform (each capture spans 8 LSE periods).
+ * @param msi_ticks:			Pointer that will contain the number of MSI cycles counted during all captures.
+ * @return status:				1 if the measurement succeeded, 0 otherwise (timeout).
+ */
+unsigned char TIM21_measure_msi(unsigned char number_of_captures, unsigned int* msi_ticks) {
+	// Local variables.
+	unsigned char status = 1;
+	unsigned char capture_idx = 0;
+	unsigned int capture_previous = 0;
+	unsigned int capture_current = 0;
+	unsigned int loop_count = 0;
+	(*msi_ticks) = 0;
+	// Enable peripheral clock.
+	RCC -> APB2ENR |= (0b1 << 2); // TIM21EN='1'.
+	// Reset timer before configuration.
+	TIM21 -> CR1 &= ~(0b1 << 0); // Disable TIM21 (CEN='0').
+	TIM21 -> DIER &= ~(0b1 << 0); // Disable update interrupt.
+	// Timer is clocked on MSI and free running.
+	TIM21 -> PSC = 0;
+	TIM21 -> ARR = 0xFFFF;
+	// Connect TI1 to LSE and capture every 8 rising edges.
+	TIM21 -> OR = (0b100 << 2); // TI1_RMP='100'.
+	TIM21 -> CCMR1 = (0b11 << 2) | (0b01 << 0); // IC1PSC='11' and CC1S='01'.
+	TIM21 -> CCER = (0b1 << 0); // CC1E='1' and CC1P='0'.
+	// Generate event to update registers and clear all flags.
+	TIM21 -> EGR |= (0b1 << 0); // UG='1'.
+	TIM21 -> SR &= 0xFFFFF9B8;
+	// Start counter.
+	TIM21 -> CNT = 0;
+	TIM21 -> CR1 |= (0b1 << 0); // CEN='1'.
+	// First capture is the reference, then accumulate periods.
+	for (capture_idx=0 ; capture_idx<=number_of_captures ; capture_idx++) {
+		loop_count = 0;
+		while (((TIM21 -> SR) & (0b1 << 1)) == 0) {
+			// Wait for capture (CC1IF='1') or timeout.
+			loop_count++;
+			if (loop_count > TIM21_TIMEOUT_COUNT) {
+				status = 0;
+				goto errors;
+			}
+		}
+		// Reading CCR1 clears CC1IF flag.
+		capture_current = (TIM21 -> CCRx[0]);
+		if (capture_idx > 0) {
+			(*msi_ticks) += ((capture_current - capture_previous) & 0xFFFF);
+		}
+		capture_previous = capture_current;
+	}
+errors:
+	// Release input capture configuration.
+	TIM21 -> CR1 &= ~(0b1 << 0); // CEN='0'.
+	TIM21 -> CCER = 0;
+	TIM21 -> CCMR1 = 0;
+	TIM21 -> OR = 0;
+	// Disable peripheral clock.
+	RCC -> APB2ENR &= ~(0b1 << 2); // TIM21EN='0'.
+	return status;
+}
+#endif
@@ -0,0 +1,84 @@
+/*
+ * cic.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "cic.h"
+
+#include "mode.h"
+
+#ifdef ADC_STREAM
+/*** CIC functions ***/
+
+/* INIT A CASCADED INTEGRATOR-COMB DECIMATOR.
+ * @param cic_ctx:		CIC filter context.
+ * @param order:		Number of integrator and comb stages (1 to CIC_ORDER_MAX).
+ * @param ratio_log2:	Decimation ratio expressed as a power of 2 (0 to CIC_RATIO_LOG2_MAX).
+ * @return:				None.
+ */
+void CIC_init(CIC_context_t* cic_ctx, unsigned char order, unsigned char ratio_log2) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Clamp parameters to keep the output within 32 bits.
+	if (order < 1) {
+		order = 1;
+	}
+	if (order > CIC_ORDER_MAX) {
+		order = CIC_ORDER_MAX;
+	}
+	if (ratio_log2 > CIC_RATIO_LOG2_MAX) {
+		ratio_log2 = CIC_RATIO_LOG2_MAX;
+	}
+	if ((order * ratio_log2) > CIC_GAIN_BITS_MAX) {
+		ratio_log2 = (CIC_GAIN_BITS_MAX / order);
+	}
+	(cic_ctx -> order) = order;
+	(cic_ctx -> ratio_log2) = ratio_log2;
+	(cic_ctx -> sample_count) = 0;
+	// Reset stages.
+	for (idx=0 ; idx<CIC_ORDER_MAX ; idx++) {
+		(cic_ctx -> integrator)[idx] = 0;
+		(cic_ctx -> comb_delay)[idx] = 0;
+	}
+}
+
+/* GET THE DC GAIN OF A CIC DECIMATOR.
+ * @param cic_ctx:	CIC filter context.
+ * @return:			Number of bits added to the input samples (order * log2(ratio)).
+ */
+unsigned char CIC_get_gain_bits(CIC_context_t* cic_ctx) {
+	return ((cic_ctx -> order) * (cic_ctx -> ratio_log2));
+}
+
+/* PROCESS A NEW SAMPLE.
+ * @param cic_ctx:	CIC filter context.
+ * @param sample:	New input sample.
+ * @param output:	Pointer that will contain the decimated output (input scale multiplied by 2^gain_bits).
+ * @return:			1 if a new output is available, 0 otherwise.
+ */
+unsigned char CIC_process(CIC_context_t* cic_ctx, unsigned int sample, unsigned int* output) {
+	// Local variables.
+	unsigned char idx = 0;
+	unsigned int stage_in = sample;
+	unsigned int stage_out = 0;
+	// Integrators (modulo 2^32 arithmetic, wrap-around is cancelled by the combs).
+	for (idx=0 ; idx<(cic_ctx -> order) ; idx++) {
+		(cic_ctx -> integrator)[idx] += stage_in;
+		stage_in = (cic_ctx -> integrator)[idx];
+	}
+	// Decimation.
+	(cic_ctx -> sample_count)++;
+	if ((cic_ctx -> sample_count) < (0b1 << (cic_ctx -> ratio_log2))) return 0;
+	(cic_ctx -> sample_count) = 0;
+	// Combs.
+	for (idx=0 ; idx<(cic_ctx -> order) ; idx++) {
+		stage_out = stage_in - (cic_ctx -> comb_delay)[idx];
+		(cic_ctx -> comb_delay)[idx] = stage_in;
+		stage_in = stage_out;
+	}
+	(*output) = stage_in;
+	return 1;
+}
+#endif
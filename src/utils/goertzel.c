@@ -0,0 +1,130 @@
+/*
+ * goertzel.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "goertzel.h"
+
+#include "math.h"
+#include "mode.h"
+
+#ifdef ADC_STREAM
+/*** GOERTZEL local macros ***/
+
+#define GOERTZEL_Q14_SHIFT			14
+#define GOERTZEL_COS_LUT_LENGTH		65 // Quarter period in 64 steps.
+#define GOERTZEL_PHASE_QUARTER		16384 // Phase is expressed in 1/65536 of turn.
+#define GOERTZEL_PHASE_QUADRANT_SHIFT	14
+#define GOERTZEL_PHASE_STEP_SHIFT	8 // Quarter phase / (LUT length - 1).
+
+/*** GOERTZEL local global variables ***/
+
+// cos(x) for x in [0;pi/2] in Q14 format.
+static const unsigned short GOERTZEL_COS_LUT[GOERTZEL_COS_LUT_LENGTH] = {
+	16384, 16379, 16364, 16340, 16305, 16261, 16207, 16143, 16069, 15986,
+	15893, 15791, 15679, 15557, 15426, 15286, 15137, 14978, 14811, 14635,
+	14449, 14256, 14053, 13842, 13623, 13395, 13160, 12916, 12665, 12406,
+	12140, 11866, 11585, 11297, 11003, 10702, 10394, 10080, 9760, 9434,
+	9102, 8765, 8423, 8076, 7723, 7366, 7005, 6639, 6270, 5897,
+	5520, 5139, 4756, 4370, 3981, 3590, 3196, 2801, 2404, 2006,
+	1606, 1205, 804, 402, 0
+};
+
+/*** GOERTZEL local functions ***/
+
+/* COMPUTE COSINE IN FIRST QUADRANT WITH LINEAR INTERPOLATION.
+ * @param phase:	Phase in 1/65536 of turn (0 to 16384).
+ * @return:			Cosine value in Q14 format.
+ */
+static int GOERTZEL_cos_quarter(unsigned int phase) {
+	// Local variables.
+	unsigned int idx = (phase >> GOERTZEL_PHASE_STEP_SHIFT);
+	int fraction = (int) (phase & ((0b1 << GOERTZEL_PHASE_STEP_SHIFT) - 1));
+	int cos_low = 0;
+	int cos_high = 0;
+	// End of table.
+	if (idx >= (GOERTZEL_COS_LUT_LENGTH - 1)) return 0;
+	cos_low = GOERTZEL_COS_LUT[idx];
+	cos_high = GOERTZEL_COS_LUT[idx + 1];
+	return (cos_low + (((cos_high - cos_low) * fraction) >> GOERTZEL_PHASE_STEP_SHIFT));
+}
+
+/* COMPUTE COSINE.
+ * @param phase:	Phase in 1/65536 of turn.
+ * @return:			Cosine value in Q14 format.
+ */
+static int GOERTZEL_cos(unsigned int phase) {
+	// Local variables.
+	unsigned int quadrant_phase = (phase & (GOERTZEL_PHASE_QUARTER - 1));
+	int result = 0;
+	// Use symmetries of the first quadrant.
+	switch ((phase >> GOERTZEL_PHASE_QUADRANT_SHIFT) & 0b11) {
+	case 0:
+		result = GOERTZEL_cos_quarter(quadrant_phase);
+		break;
+	case 1:
+		result = -GOERTZEL_cos_quarter(GOERTZEL_PHASE_QUARTER - quadrant_phase);
+		break;
+	case 2:
+		result = -GOERTZEL_cos_quarter(quadrant_phase);
+		break;
+	default:
+		result = GOERTZEL_cos_quarter(GOERTZEL_PHASE_QUARTER - quadrant_phase);
+		break;
+	}
+	return result;
+}
+
+/*** GOERTZEL functions ***/
+
+/* INIT A GOERTZEL DETECTOR.
+ * @param goertzel_ctx:				Detector context.
+ * @param target_frequency_hz:		Frequency to detect in Hz (must be lower than half the sampling frequency).
+ * @param sampling_frequency_hz:	Input sampling frequency in Hz.
+ * @return:							None.
+ */
+void GOERTZEL_init(GOERTZEL_context_t* goertzel_ctx, unsigned int target_frequency_hz, unsigned int sampling_frequency_hz) {
+	// Local variables.
+	unsigned int phase = 0;
+	// Compute normalized frequency in 1/65536 of turn.
+	if (sampling_frequency_hz != 0) {
+		phase = (unsigned int) ((((unsigned long long) target_frequency_hz) << 16) / (sampling_frequency_hz));
+	}
+	(goertzel_ctx -> coefficient) = 2 * GOERTZEL_cos(phase);
+	(goertzel_ctx -> s1) = 0;
+	(goertzel_ctx -> s2) = 0;
+}
+
+/* PROCESS A NEW SAMPLE.
+ * @param goertzel_ctx:	Detector context.
+ * @param sample:		New input sample (DC component should be removed to limit dynamic range).
+ * @return:				None.
+ */
+void GOERTZEL_process(GOERTZEL_context_t* goertzel_ctx, int sample) {
+	// Local variables.
+	long long feedback = ((long long) (goertzel_ctx -> coefficient)) * (goertzel_ctx -> s1);
+	int s0 = sample + ((int) (feedback >> GOERTZEL_Q14_SHIFT)) - (goertzel_ctx -> s2);
+	// Update state.
+	(goertzel_ctx -> s2) = (goertzel_ctx -> s1);
+	(goertzel_ctx -> s1) = s0;
+}
+
+/* GET THE MAGNITUDE AT THE TARGET FREQUENCY.
+ * @param goertzel_ctx:	Detector context.
+ * @return:				DFT magnitude (N * A / 2 for a sine wave of amplitude A over N samples).
+ */
+unsigned int GOERTZEL_get_magnitude(GOERTZEL_context_t* goertzel_ctx) {
+	// Local variables.
+	long long s1 = (goertzel_ctx -> s1);
+	long long s2 = (goertzel_ctx -> s2);
+	long long power = 0;
+	// |X|^2 = s1^2 + s2^2 - coefficient * s1 * s2.
+	power = (s1 * s1) + (s2 * s2) - ((((goertzel_ctx -> coefficient) * s1) >> GOERTZEL_Q14_SHIFT) * s2);
+	if (power < 0) {
+		power = 0;
+	}
+	return MATH_sqrt((unsigned long long) power);
+}
+#endif
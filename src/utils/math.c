@@ -11,6 +11,8 @@
 
 #define MATH_MEDIAN_FILTER_LENGTH_MAX	0xFF
 #define MATH_DECIMAL_MAX_DIGITS			10
+#define MATH_CRC16_POLYNOMIAL			0x1021 // CCITT.
+#define MATH_CRC16_INIT					0xFFFF
 
 /*** MATH functions ***/
 
@@ -96,3 +98,50 @@ unsigned int MATH_median_filter(unsigned int* data, unsigned char median_length,
 	}
 	return filter_out;
 }
+
+/* COMPUTE INTEGER SQUARE ROOT.
+ * @param value:	Input value.
+ * @return root:	Largest integer whose square is lower than or equal to the input value.
+ */
+unsigned int MATH_sqrt(unsigned long long value) {
+	// Local variables.
+	unsigned long long remainder = value;
+	unsigned long long root = 0;
+	unsigned long long bit = (0b1ULL << 62);
+	// Start from the highest power of 4 lower than the input value.
+	while (bit > remainder) {
+		bit >>= 2;
+	}
+	// Compute result bit by bit.
+	while (bit != 0) {
+		if (remainder >= (root + bit)) {
+			remainder -= (root + bit);
+			root = (root >> 1) + bit;
+		}
+		else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return ((unsigned int) root);
+}
+
+/* COMPUTE CRC16-CCITT.
+ * @param data:			Input buffer.
+ * @param data_length:	Number of bytes.
+ * @return crc:			CRC of the input buffer (initial value 0xFFFF).
+ */
+unsigned short MATH_crc16(unsigned char* data, unsigned int data_length) {
+	// Local variables.
+	unsigned short crc = MATH_CRC16_INIT;
+	unsigned int idx = 0;
+	unsigned char bit_idx = 0;
+	// Compute bit by bit (no table to save flash).
+	for (idx=0 ; idx<data_length ; idx++) {
+		crc ^= (((unsigned short) data[idx]) << 8);
+		for (bit_idx=0 ; bit_idx<8 ; bit_idx++) {
+			crc = ((crc & 0x8000) != 0) ? ((crc << 1) ^ MATH_CRC16_POLYNOMIAL) : (crc << 1);
+		}
+	}
+	return crc;
+}
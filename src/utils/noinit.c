@@ -0,0 +1,141 @@
+/*
+ * noinit.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "noinit.h"
+
+#include "math.h"
+#include "mode.h"
+
+#ifdef RETAINED_DATA
+/*** NOINIT local macros ***/
+
+#define NOINIT_MAGIC			0x4E4F4931 // "NOI1".
+#define NOINIT_NJ_PER_MJ		1000000
+
+/*** NOINIT local structures ***/
+
+typedef struct {
+	unsigned int magic;
+	unsigned short crc;
+	NOINIT_data_t data;
+} NOINIT_context_t;
+
+/*** NOINIT local global variables ***/
+
+// Placed in the .noinit section which is neither loaded nor zeroed by Reset_Handler.
+static NOINIT_context_t noinit_ctx __attribute__((section(".noinit")));
+
+/*** NOINIT local functions ***/
+
+/* COMPUTE CRC OF THE RETAINED DATA.
+ * @param:	None.
+ * @return:	CRC16 of the data field.
+ */
+static unsigned short NOINIT_compute_crc(void) {
+	return MATH_crc16((unsigned char*) &(noinit_ctx.data), sizeof(NOINIT_data_t));
+}
+
+/* SEAL THE RETAINED DATA AFTER AN UPDATE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void NOINIT_seal(void) {
+	noinit_ctx.crc = NOINIT_compute_crc();
+	noinit_ctx.magic = NOINIT_MAGIC;
+}
+
+/*** NOINIT functions ***/
+
+/* CHECK RETAINED DATA AND RESET IT IF CORRUPTED.
+ * @param:	None.
+ * @return:	1 if the data survived the last reset, 0 if it was reset (power-on or corruption).
+ */
+unsigned char NOINIT_init(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Check header.
+	if ((noinit_ctx.magic == NOINIT_MAGIC) && (noinit_ctx.crc == NOINIT_compute_crc())) return 1;
+	// Content is random after power-on.
+	for (idx=0 ; idx<NOINIT_RESET_SOURCE_LAST ; idx++) {
+		noinit_ctx.data.reset_count[idx] = 0;
+	}
+	noinit_ctx.data.energy_mj = 0;
+	noinit_ctx.data.energy_remainder_nj = 0;
+	NOINIT_seal();
+	return 0;
+}
+
+/* COUNT A WARM RESET.
+ * @param reset_source:	Source of the last reset.
+ * @return:				None.
+ */
+void NOINIT_record_reset(NOINIT_reset_source_t reset_source) {
+	if (reset_source < NOINIT_RESET_SOURCE_LAST) {
+		noinit_ctx.data.reset_count[reset_source]++;
+		NOINIT_seal();
+	}
+}
+
+/* ACCUMULATE OUTPUT ENERGY.
+ * @param vout_mv:			Output voltage in mV.
+ * @param iout_ua:			Output current in uA.
+ * @param duration_seconds:	Duration of the measurement period.
+ * @return:					None.
+ */
+void NOINIT_add_energy(unsigned int vout_mv, unsigned int iout_ua, unsigned int duration_seconds) {
+	// Local variables.
+	unsigned long long energy_nj = ((unsigned long long) vout_mv) * iout_ua * duration_seconds; // mV * uA = nW.
+	// Keep remainder to avoid losing low power contributions.
+	energy_nj += noinit_ctx.data.energy_remainder_nj;
+	noinit_ctx.data.energy_mj += (unsigned int) (energy_nj / NOINIT_NJ_PER_MJ);
+	noinit_ctx.data.energy_remainder_nj = (unsigned int) (energy_nj % NOINIT_NJ_PER_MJ);
+	NOINIT_seal();
+}
+
+/* GET A COPY OF RETAINED DATA.
+ * @param data:	Pointer that will contain the retained data.
+ * @return:		None.
+ */
+void NOINIT_get_data(NOINIT_data_t* data) {
+	(*data) = noinit_ctx.data;
+}
+
+/* RESTORE OUTPUT ENERGY SAVED OUTSIDE RAM.
+ * @param energy_mj:	Energy in mJ.
+ * @return:				None.
+ */
+void NOINIT_restore_energy(unsigned int energy_mj) {
+	noinit_ctx.data.energy_mj = energy_mj;
+	noinit_ctx.data.energy_remainder_nj = 0;
+	NOINIT_seal();
+}
+
+/* RESET WARM RESET COUNTERS (ENERGY IS KEPT).
+ * @param:	None.
+ * @return:	None.
+ */
+void NOINIT_clear_reset_counts(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	for (idx=0 ; idx<NOINIT_RESET_SOURCE_LAST ; idx++) {
+		noinit_ctx.data.reset_count[idx] = 0;
+	}
+	NOINIT_seal();
+}
+
+/* RESTORE A WARM RESET COUNTER SAVED OUTSIDE RAM.
+ * @param reset_source:	Source of the reset.
+ * @param reset_count:	Number of resets.
+ * @return:				None.
+ */
+void NOINIT_restore_reset_count(NOINIT_reset_source_t reset_source, unsigned int reset_count) {
+	if (reset_source < NOINIT_RESET_SOURCE_LAST) {
+		noinit_ctx.data.reset_count[reset_source] = reset_count;
+		NOINIT_seal();
+	}
+}
+#endif
@@ -15,6 +15,10 @@
 #define PARSER_PARAMETER_BINARY_MAX_DIGITS		1
 #define PARSER_PARAMETER_HEXADECIMAL_MAX_BYTES	4
 #define PARSER_PARAMETER_DECIMAL_MAX_DIGITS		10
+#define PARSER_PARAMETER_FIXED_POINT_MAX		0x7FFFFFFF
+#define PARSER_PREFIX_MILLI						'm'
+#define PARSER_PREFIX_MICRO						'u'
+#define PARSER_PREFIX_KILO						'k'
 
 /*** PARSER local functions ***/
 
@@ -38,6 +42,27 @@ static PARSER_Status PARSER_search_separator(PARSER_Context* parser_ctx, char se
 	return status;
 }
 
+/* CHECK IF THE END OF THE CURRENT PARAMETER MATCHES A UNIT SYMBOL.
+ * @param parser_ctx:   Parser structure.
+ * @param start_idx:	Index of the first unit character.
+ * @param end_idx:		Index of the last parameter character.
+ * @param unit:			Expected unit symbol.
+ * @return status:      Comparison result.
+ */
+static PARSER_Status PARSER_compare_unit(PARSER_Context* parser_ctx, unsigned char start_idx, unsigned char end_idx, char* unit) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Compare all characters.
+	while (unit[idx] != STRING_CHAR_NULL) {
+		if (((start_idx + idx) > end_idx) || ((parser_ctx -> rx_buf)[start_idx + idx] != unit[idx])) {
+			return PARSER_ERROR_PARAMETER_UNIT_INVALID;
+		}
+		idx++;
+	}
+	// Unit must end the parameter.
+	return ((start_idx + idx) == (end_idx + 1)) ? PARSER_SUCCESS : PARSER_ERROR_PARAMETER_UNIT_INVALID;
+}
+
 /*** PARSER functions ***/
 
 /* CHECK EQUALITY BETWEEN A GIVEN COMMAND OR HEADER AND THE CURRENT AT COMMAND BUFFER.
@@ -231,6 +256,133 @@ errors:
 	return status;
 }
 
+/* RETRIEVE A FIXED-POINT PARAMETER WITH UNIT SUFFIX IN THE CURRENT AT BUFFER (EX: 1.25A, 250mA, 12.6V).
+ * @param parser_ctx:   Parser structure.
+ * @param separator:    Parameter separator character.
+ * @param last_param:   Indicates if the parameter to scan is the last in AT command.
+ * @param unit:			Expected unit symbol, optionally preceded by a 'k', 'm' or 'u' prefix.
+ * @param unit_power:	Power of 10 of the returned value relative to the unit (ex: 6 to get uA from A).
+ * @param min:			Minimum allowed scaled value.
+ * @param max:			Maximum allowed scaled value.
+ * @param param:		Pointer that will contain the scaled value (an integer without unit is considered already scaled).
+ * @return status:      Searching result.
+ */
+PARSER_Status PARSER_get_fixed_point_parameter(PARSER_Context* parser_ctx, char separator, unsigned char last_param, char* unit, unsigned char unit_power, int min, int max, int* param) {
+	// Local variables.
+	PARSER_Status status = PARSER_ERROR_UNKNOWN_COMMAND;
+	unsigned char idx = 0;
+	unsigned char end_idx = 0;
+	unsigned char param_negative_flag = 0;
+	unsigned char point_found = 0;
+	unsigned char number_of_digits = 0;
+	signed char power = 0;
+	unsigned long long mantissa = 0;
+	unsigned char character = 0;
+	// Search separator if required.
+	if (last_param != 0) {
+		end_idx = (parser_ctx -> rx_buf_length) - 1;
+	}
+	else {
+		if (PARSER_search_separator(parser_ctx, separator) == PARSER_SUCCESS) {
+			end_idx = (parser_ctx -> separator_idx) - 1;
+		}
+		else {
+			status = PARSER_ERROR_SEPARATOR_NOT_FOUND;
+			goto errors;
+		}
+	}
+	// Manage negative numbers.
+	if ((parser_ctx -> rx_buf)[parser_ctx -> start_idx] == STRING_CHAR_MINUS) {
+		param_negative_flag = 1;
+		(parser_ctx -> start_idx)++;
+	}
+	// Check if parameter is not empty.
+	if ((end_idx + 1) <= (parser_ctx -> start_idx)) {
+		status = PARSER_ERROR_PARAMETER_NOT_FOUND;
+		goto errors;
+	}
+	// Scan number.
+	for (idx=(parser_ctx -> start_idx) ; idx<=end_idx ; idx++) {
+		character = (parser_ctx -> rx_buf)[idx];
+		if (STRING_is_decimal_char(character) != 0) {
+			mantissa = (mantissa * 10) + STRING_ascii_to_hexa(character);
+			if (mantissa > PARSER_PARAMETER_FIXED_POINT_MAX) {
+				status = PARSER_ERROR_PARAMETER_DEC_OVERFLOW;
+				goto errors;
+			}
+			number_of_digits++;
+			if (point_found != 0) power--;
+		}
+		else if ((character == STRING_CHAR_DOT) && (point_found == 0)) {
+			point_found = 1;
+		}
+		else {
+			break;
+		}
+	}
+	if (number_of_digits == 0) {
+		status = PARSER_ERROR_PARAMETER_DEC_INVALID;
+		goto errors;
+	}
+	// Scan unit.
+	if (idx <= end_idx) {
+		if (PARSER_compare_unit(parser_ctx, idx, end_idx, unit) != PARSER_SUCCESS) {
+			// Try with a prefix.
+			character = (parser_ctx -> rx_buf)[idx];
+			if (character == PARSER_PREFIX_KILO) {
+				power += 3;
+			}
+			else if (character == PARSER_PREFIX_MILLI) {
+				power -= 3;
+			}
+			else if (character == PARSER_PREFIX_MICRO) {
+				power -= 6;
+			}
+			else {
+				status = PARSER_ERROR_PARAMETER_UNIT_INVALID;
+				goto errors;
+			}
+			status = PARSER_compare_unit(parser_ctx, (idx + 1), end_idx, unit);
+			if (status != PARSER_SUCCESS) goto errors;
+		}
+		power += unit_power;
+	}
+	else if (point_found != 0) {
+		// A fractional value without unit would be ambiguous.
+		status = PARSER_ERROR_PARAMETER_UNIT_INVALID;
+		goto errors;
+	}
+	// Scale to requested unit.
+	for (; power>0 ; power--) {
+		mantissa *= 10;
+		if (mantissa > PARSER_PARAMETER_FIXED_POINT_MAX) {
+			status = PARSER_ERROR_PARAMETER_DEC_OVERFLOW;
+			goto errors;
+		}
+	}
+	for (; power<0 ; power++) {
+		// Only trailing zeros can be dropped.
+		if ((mantissa % 10) != 0) {
+			status = PARSER_ERROR_PARAMETER_RESOLUTION;
+			goto errors;
+		}
+		mantissa /= 10;
+	}
+	(*param) = (param_negative_flag != 0) ? (-1) * ((int) mantissa) : ((int) mantissa);
+	// Check range.
+	if (((*param) < min) || ((*param) > max)) {
+		status = PARSER_ERROR_PARAMETER_OUT_OF_RANGE;
+		goto errors;
+	}
+	status = PARSER_SUCCESS;
+	// Update start index after decoding parameter.
+	if ((parser_ctx -> separator_idx) > 0) {
+		(parser_ctx -> start_idx) = (parser_ctx -> separator_idx) + 1;
+	}
+errors:
+	return status;
+}
+
 /* RETRIEVE A HEXADECIMAL BYTE ARRAY IN THE CURRENT AT BUFFER.
  * @param parser_ctx:       Parser structure.
  * @param separator:        Parameter separator character.